@@ -0,0 +1,351 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "async_file_reader.hpp"
+#include "file_reader.hpp"
+#include "pcap/utils/byte_swapper.hpp"
+#include "pcap/utils/decompressor.hpp"
+#include "pcap/utils/metrics.hpp"
+
+// the read result is a signed 32-bit count
+constexpr uint64_t maximumReadSize{std::numeric_limits<int32_t>::max()};
+
+namespace pcap
+{
+bool AsyncFileReader::NextAwaiter::await_ready()
+{
+	try
+	{
+		reader_.step_ = reader_.decode();
+	}
+	catch (...)
+	{
+		reader_.error_ = std::current_exception();
+		return true;
+	}
+
+	return reader_.step_ != Step::refill;
+}
+
+void AsyncFileReader::NextAwaiter::await_suspend(std::coroutine_handle<> waiter)
+{
+	reader_.waiter_ = waiter;
+	reader_.refill();
+}
+
+const Packet* AsyncFileReader::NextAwaiter::await_resume()
+{
+	if (reader_.error_)
+	{
+		std::rethrow_exception(std::exchange(reader_.error_, nullptr));
+	}
+
+	return reader_.step_ == Step::packet ? &reader_.packet_ : nullptr;
+}
+
+AsyncFileReader::AsyncFileReader(EventLoop& loop, const std::string& fileName) : AsyncFileReader(loop, fileName, Options{}) {}
+
+AsyncFileReader::AsyncFileReader(EventLoop& loop, const std::string& fileName, const Options& options)
+	: loop_{loop}
+	, fileName_{fileName}
+	, read_{}
+	, buffer_(std::max<uint64_t>(options.bufferSize, sizeof(FileReader::FileHeader)))
+	, packet_{}
+	, pcapng_{}
+	, filter_{}
+	, waiter_{}
+	, error_{}
+	, submitted_{}
+	, format_{Format::unknown}
+	, step_{Step::end}
+	, fileEndian_{std::endian::native}
+	, nanoseconds_{false}
+	, linkLayerType_{}
+	, bufferOffset_{}
+	, begin_{}
+	, end_{}
+	, required_{}
+	, fileSize_{}
+	, readPackets_{}
+	, descriptor_{::open(fileName.c_str(), O_RDONLY | O_CLOEXEC)}
+{
+	if (descriptor_ == -1)
+	{
+		throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot open '{}': {}.", fileName, std::strerror(errno)));
+	}
+
+	struct stat status{};
+
+	if (::fstat(descriptor_, &status) == -1)
+	{
+		const auto error{errno};
+		::close(descriptor_);
+		throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot open '{}': {}.", fileName, std::strerror(error)));
+	}
+
+	fileSize_ = static_cast<uint64_t>(status.st_size);
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+	::close(descriptor_);
+}
+
+AsyncFileReader::NextAwaiter AsyncFileReader::next() noexcept
+{
+	return NextAwaiter{*this};
+}
+
+void AsyncFileReader::setFilter(Filter filter) noexcept
+{
+	filter_ = std::move(filter);
+}
+
+uint64_t AsyncFileReader::fileSize() const noexcept
+{
+	return fileSize_;
+}
+
+uint64_t AsyncFileReader::readBytes() const noexcept
+{
+	return bufferOffset_ + begin_;
+}
+
+uint64_t AsyncFileReader::readPackets() const noexcept
+{
+	return readPackets_;
+}
+
+AsyncFileReader::Step AsyncFileReader::decode()
+{
+	switch (format_)
+	{
+	case Format::unknown:
+		return decodeFileHeader();
+	case Format::pcap:
+		return decodePcap();
+	case Format::pcapng:
+		return decodePcapng();
+	}
+
+	return Step::end;
+}
+
+AsyncFileReader::Step AsyncFileReader::decodeFileHeader()
+{
+	if (end_ - begin_ < sizeof(FileReader::FileHeader))
+	{
+		return need(sizeof(FileReader::FileHeader));
+	}
+
+	const std::span<const uint8_t> data{buffer_.data() + begin_, sizeof(FileReader::FileHeader)};
+
+	if (Decompressor::detect(data) != Decompressor::Format::none)
+	{
+		throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot read '{}': compressed files are not supported.", fileName_));
+	}
+
+	// the section header is the first block, it is decoded with the others
+	if (PcapngDecoder::isSectionHeader(data))
+	{
+		format_ = Format::pcapng;
+
+		return decodePcapng();
+	}
+
+	if (not FileReader::validateFileHeader(data))
+	{
+		throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot read '{}': invalid file header.", fileName_));
+	}
+
+	fileEndian_ = FileReader::getFileEndian(data[0]);
+	nanoseconds_ = FileReader::getTimestampType(data[0]) == FileReader::TimestampType::nanoseconds;
+
+	FileReader::FileHeader header{};
+	std::memcpy(&header, data.data(), sizeof(FileReader::FileHeader));
+
+	ByteSwapper{}(header, fileEndian_);
+
+	linkLayerType_ = header.linkLayerType;
+	format_ = Format::pcap;
+	begin_ += sizeof(FileReader::FileHeader);
+
+	return decodePcap();
+}
+
+AsyncFileReader::Step AsyncFileReader::decodePcap()
+{
+	while (true)
+	{
+		if (end_ - begin_ < sizeof(FileReader::PacketHeader))
+		{
+			return need(sizeof(FileReader::PacketHeader));
+		}
+
+		FileReader::PacketHeader header{};
+		std::memcpy(&header, buffer_.data() + begin_, sizeof(FileReader::PacketHeader));
+		ByteSwapper{}(header, fileEndian_);
+
+		const auto size{sizeof(FileReader::PacketHeader) + header.currentLength};
+
+		if (end_ - begin_ < size)
+		{
+			return need(size);
+		}
+
+		const std::span<const uint8_t> data{buffer_.data() + begin_ + sizeof(FileReader::PacketHeader), header.currentLength};
+		begin_ += size;
+		++readPackets_;
+
+		if (not filter_(data, linkLayerType_))
+		{
+			continue;
+		}
+
+		const auto timestamp{std::chrono::seconds{header.timestampSec} +
+				     (nanoseconds_ ? std::chrono::nanoseconds{header.timestampMicrosec} :
+						     std::chrono::nanoseconds{std::chrono::microseconds{header.timestampMicrosec}})};
+
+		packet_.fill(timestamp, linkLayerType_, data);
+
+		return Step::packet;
+	}
+}
+
+AsyncFileReader::Step AsyncFileReader::decodePcapng()
+{
+	while (true)
+	{
+		if (end_ - begin_ < PcapngDecoder::minimumBlockSize)
+		{
+			return need(PcapngDecoder::minimumBlockSize);
+		}
+
+		const auto header{pcapng_.blockHeader({buffer_.data() + begin_, end_ - begin_})};
+
+		if (header.length == 0)
+		{
+			throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot read '{}' pcapng block header: file corrupted.", fileName_));
+		}
+
+		if (end_ - begin_ < header.length)
+		{
+			return need(header.length);
+		}
+
+		const std::span<const uint8_t> block{buffer_.data() + begin_, header.length};
+		const auto offset{bufferOffset_ + begin_};
+		begin_ += header.length;
+
+		if (const auto prefixSize{PcapngDecoder::packetPrefixSize(header.type)})
+		{
+			PcapngDecoder::Record record{};
+
+			if (not pcapng_.packet(header, block.first(std::min<uint64_t>(prefixSize, block.size())), record))
+			{
+				throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot read '{}' pcapng packet block: file corrupted.", fileName_));
+			}
+
+			const auto data{block.subspan(prefixSize, record.currentLength)};
+			++readPackets_;
+
+			if (not filter_(data, record.linkLayerType))
+			{
+				continue;
+			}
+
+			packet_.fill(record.timestamp, record.linkLayerType, data);
+
+			return Step::packet;
+		}
+
+		if (not pcapng_.metadata(block, offset))
+		{
+			throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot read '{}' pcapng block: file corrupted.", fileName_));
+		}
+	}
+}
+
+AsyncFileReader::Step AsyncFileReader::need(uint64_t size)
+{
+	if (begin_ == end_ and bufferOffset_ + end_ == fileSize_ and format_ != Format::unknown)
+	{
+		return Step::end;
+	}
+
+	if (bufferOffset_ + begin_ + size > fileSize_)
+	{
+		throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot read '{}': file corrupted.", fileName_));
+	}
+
+	required_ = size;
+
+	return Step::refill;
+}
+
+void AsyncFileReader::refill()
+{
+	// the decoded bytes are dropped, which also invalidates the previous packet
+	if (begin_ != 0)
+	{
+		std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+		bufferOffset_ += begin_;
+		end_ -= begin_;
+		begin_ = 0;
+	}
+
+	if (buffer_.size() < required_)
+	{
+		buffer_.resize(required_);
+	}
+
+	const auto size{std::min({buffer_.size() - end_, fileSize_ - bufferOffset_ - end_, maximumReadSize})};
+
+	read_ = EventLoop::Read{descriptor_, buffer_.data() + end_, static_cast<uint32_t>(size), bufferOffset_ + end_, &AsyncFileReader::complete, this};
+	PCAP_METRICS(submitted_ = std::chrono::steady_clock::now());
+
+	loop_.submit(read_);
+}
+
+void AsyncFileReader::complete(EventLoop::Read& read, int32_t result)
+{
+	auto& reader{*static_cast<AsyncFileReader*>(read.context)};
+
+	PCAP_METRICS(Metrics::recordRead(std::chrono::steady_clock::now() - reader.submitted_, std::max(result, 0)));
+
+	try
+	{
+		if (result <= 0)
+		{
+			// the file was truncated while being read
+			throw std::runtime_error(std::format("pcap::AsyncFileReader [exception]: cannot read '{}': {}.", reader.fileName_,
+							     result == 0 ? "unexpected end of file" : std::strerror(-result)));
+		}
+
+		reader.end_ += static_cast<uint64_t>(result);
+		reader.step_ = reader.decode();
+
+		// a short read may still miss part of the record
+		if (reader.step_ == Step::refill)
+		{
+			reader.refill();
+			return;
+		}
+	}
+	catch (...)
+	{
+		reader.error_ = std::current_exception();
+	}
+
+	reader.loop_.schedule(reader.waiter_);
+}
+} // namespace pcap
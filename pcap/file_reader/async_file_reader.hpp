@@ -0,0 +1,162 @@
+#ifndef PCAP_ASYNC_FILE_READER_HPP
+#define PCAP_ASYNC_FILE_READER_HPP
+
+#include <bit>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "pcapng_decoder.hpp"
+#include "pcap/filter/filter.hpp"
+#include "pcap/packet/packet.hpp"
+#include "pcap/utils/event_loop.hpp"
+
+namespace pcap
+{
+/**
+ * @brief Reader of uncompressed PCAP and pcapng files for coroutines running on an `EventLoop`.
+ * 
+ * `co_await reader.next()` yields the next packet without blocking the loop thread: records are decoded from a
+ * buffer refilled with asynchronous reads, the coroutine is only suspended while a refill is in flight. Packets
+ * refer to the buffer, like in `FileReader::Mode::readAhead` they stay valid until the next `next()`.
+ * 
+ * @code
+ * EventLoop::Task count(AsyncFileReader& reader, uint64_t& bytes)
+ * {
+ * 	while (const auto* packet{co_await reader.next()})
+ * 	{
+ * 		bytes += packet->size();
+ * 	}
+ * }
+ * @endcode
+ */
+class AsyncFileReader final
+{
+public:
+	struct Options
+	{
+		// grows for records larger than the buffer
+		uint64_t bufferSize{256 * 1024};
+	};
+
+	/**
+	 * @brief Awaitable next packet, `co_await` yields a pointer to the packet or `nullptr` at the end of file.
+	 */
+	class NextAwaiter final
+	{
+	public:
+		explicit NextAwaiter(AsyncFileReader& reader) noexcept : reader_{reader} {}
+
+		bool await_ready();
+		void await_suspend(std::coroutine_handle<> waiter);
+		const Packet* await_resume();
+
+	private:
+		AsyncFileReader& reader_;
+	};
+
+	/**
+	 * @brief Opens a file, its header is read by the first `next()`.
+	 * 
+	 * @param loop Event loop the reads are submitted to
+	 * @param fileName File name
+	 */
+	AsyncFileReader(EventLoop& loop, const std::string& fileName);
+	AsyncFileReader(EventLoop& loop, const std::string& fileName, const Options& options);
+	AsyncFileReader(const AsyncFileReader&) = delete;
+	AsyncFileReader(AsyncFileReader&&) = delete;
+	AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+	AsyncFileReader& operator=(AsyncFileReader&&) = delete;
+	~AsyncFileReader();
+
+	/**
+	 * @brief Reads the next packet, e.g. `while (const auto* packet{co_await reader.next()})`.
+	 * 
+	 * @return Next packet awaitable
+	 */
+	[[nodiscard]] NextAwaiter next() noexcept;
+
+	/**
+	 * @brief Sets the filter applied to raw packet bytes, see `FileReader::setFilter()`.
+	 * 
+	 * @param filter Compiled packet filter
+	 */
+	void setFilter(Filter filter) noexcept;
+
+	/**
+	 * @brief Returns the file size.
+	 * 
+	 * @return File size
+	 */
+	[[nodiscard]] uint64_t fileSize() const noexcept;
+
+	/**
+	 * @brief Returns the number of bytes decoded.
+	 * 
+	 * @return Number of bytes read
+	 */
+	[[nodiscard]] uint64_t readBytes() const noexcept;
+
+	/**
+	 * @brief Returns the number of packets read, including the ones rejected by the filter.
+	 * 
+	 * @return Number of packets read
+	 */
+	[[nodiscard]] uint64_t readPackets() const noexcept;
+
+private:
+	enum class Step : uint8_t
+	{
+		packet,
+		refill,
+		end
+	};
+
+	enum class Format : uint8_t
+	{
+		unknown,
+		pcap,
+		pcapng
+	};
+
+	Step decode();
+	Step decodeFileHeader();
+	Step decodePcap();
+	Step decodePcapng();
+	Step need(uint64_t size);
+	void refill();
+
+	static void complete(EventLoop::Read& read, int32_t result);
+
+	EventLoop& loop_;
+	std::string fileName_;
+	EventLoop::Read read_;
+	std::vector<uint8_t> buffer_;
+	Packet packet_;
+	PcapngDecoder pcapng_;
+	Filter filter_;
+	std::coroutine_handle<> waiter_;
+	std::exception_ptr error_;
+	// submission time of the read in flight
+	std::chrono::steady_clock::time_point submitted_;
+	Format format_;
+	Step step_;
+	std::endian fileEndian_;
+	bool nanoseconds_;
+	uint32_t linkLayerType_;
+	// the buffer holds file bytes [bufferOffset_, bufferOffset_ + end_), the ones before begin_ are decoded
+	uint64_t bufferOffset_;
+	uint64_t begin_;
+	uint64_t end_;
+	// bytes from begin_ the next record needs
+	uint64_t required_;
+	uint64_t fileSize_;
+	uint64_t readPackets_;
+	int descriptor_;
+};
+} // namespace pcap
+
+#endif // PCAP_ASYNC_FILE_READER_HPP
@@ -0,0 +1,236 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#include "file_follower.hpp"
+#include "pcap/utils/log.hpp"
+
+// an open file that is unlinked only reports `IN_ATTRIB`, `IN_DELETE_SELF` waits for its last descriptor to be closed
+constexpr uint32_t watchedEvents{IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF};
+
+namespace pcap
+{
+FileFollower::FileFollower(const std::string& fileName) : FileFollower(fileName, Options{}) {}
+
+FileFollower::FileFollower(const std::string& fileName, const Options& options)
+	: fileName_{fileName}
+	, options_{options}
+	, reader_{}
+	, filter_{}
+	, deduplicator_{}
+	, notify_{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+	, wakeup_{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)}
+	, descriptor_{::open(fileName.c_str(), O_RDONLY | O_CLOEXEC)}
+	, gone_{false}
+{
+	// the watch exists before the first read, so no write can slip between a read reaching the end and the wait
+	if (notify_ == -1 or wakeup_ == -1 or descriptor_ == -1 or ::inotify_add_watch(notify_, fileName.c_str(), watchedEvents) == -1)
+	{
+		const auto error{errno};
+
+		if (notify_ != -1)
+		{
+			::close(notify_);
+		}
+
+		if (wakeup_ != -1)
+		{
+			::close(wakeup_);
+		}
+
+		if (descriptor_ != -1)
+		{
+			::close(descriptor_);
+		}
+
+		throw std::runtime_error(std::format("pcap::FileFollower [exception]: cannot watch '{}': {}.", fileName, std::strerror(error)));
+	}
+}
+
+FileFollower::~FileFollower()
+{
+	::close(notify_);
+	::close(wakeup_);
+	::close(descriptor_);
+}
+
+bool FileFollower::readNextPacket(Packet& packet, std::stop_token token)
+{
+	while (true)
+	{
+		if (open() and reader_->readNextPacket(packet))
+		{
+			return true;
+		}
+
+		// everything written before the file was moved or deleted has been read
+		if (gone_)
+		{
+			return false;
+		}
+
+		switch (wait(token))
+		{
+		case Event::modified:
+			break;
+		case Event::gone:
+			PCAP_LOG(LogLevel::info, "pcap::FileFollower: file '{}' was moved or deleted", fileName_);
+			gone_ = true;
+			break;
+		default:
+			return false;
+		}
+
+		if (reader_)
+		{
+			reader_->refresh();
+		}
+	}
+}
+
+uint64_t FileFollower::follow(const Callback& callback, std::stop_token token)
+{
+	Packet packet;
+	uint64_t packets{};
+
+	while (readNextPacket(packet, token))
+	{
+		callback(packet);
+		++packets;
+	}
+
+	return packets;
+}
+
+void FileFollower::setFilter(Filter filter)
+{
+	if (reader_)
+	{
+		reader_->setFilter(std::move(filter));
+		return;
+	}
+
+	filter_ = std::move(filter);
+}
+
+void FileFollower::setDeduplicator(Deduplicator deduplicator)
+{
+	if (reader_)
+	{
+		reader_->setDeduplicator(std::move(deduplicator));
+		return;
+	}
+
+	deduplicator_ = std::move(deduplicator);
+}
+
+uint64_t FileFollower::readPackets() const noexcept
+{
+	return reader_ ? reader_->readPackets() : 0;
+}
+
+bool FileFollower::open()
+{
+	if (reader_)
+	{
+		return true;
+	}
+
+	// the writer may not have written the file header yet
+	struct stat status{};
+
+	if (::stat(fileName_.c_str(), &status) == -1 or static_cast<uint64_t>(status.st_size) < sizeof(FileReader::FileHeader))
+	{
+		return false;
+	}
+
+	reader_.emplace(fileName_, FileReader::Options{.mode = FileReader::Mode::stream, .follow = true});
+	reader_->setFilter(std::move(filter_));
+	reader_->setDeduplicator(std::move(deduplicator_));
+
+	return true;
+}
+
+FileFollower::Event FileFollower::wait(std::stop_token& token)
+{
+	const std::stop_callback stop{token,
+				      [this]
+				      {
+					      const uint64_t value{1};
+					      static_cast<void>(::write(wakeup_, &value, sizeof(value)));
+				      }};
+
+	pollfd descriptors[]{{notify_, POLLIN, 0}, {wakeup_, POLLIN, 0}};
+	const auto timeout{options_.idleTimeout.count() != 0 ? static_cast<int>(options_.idleTimeout.count()) : -1};
+
+	while (true)
+	{
+		const auto result{::poll(descriptors, std::size(descriptors), timeout)};
+
+		if (result == -1 and errno == EINTR)
+		{
+			continue;
+		}
+
+		if (result == -1)
+		{
+			throw std::runtime_error(std::format("pcap::FileFollower [exception]: cannot watch '{}': {}.", fileName_, std::strerror(errno)));
+		}
+
+		break;
+	}
+
+	if (descriptors[1].revents != 0)
+	{
+		uint64_t value{};
+		static_cast<void>(::read(wakeup_, &value, sizeof(value)));
+
+		return Event::stopped;
+	}
+
+	if (descriptors[0].revents == 0)
+	{
+		return Event::idle;
+	}
+
+	// all queued events are consumed: a single wake-up covers every write made so far
+	alignas(inotify_event) uint8_t buffer[4096];
+	auto event{Event::modified};
+	ssize_t size{};
+
+	while ((size = ::read(notify_, buffer, sizeof(buffer))) > 0)
+	{
+		for (ssize_t offset{}; offset < size;)
+		{
+			const auto* notification{reinterpret_cast<const inotify_event*>(buffer + offset)};
+
+			if ((notification->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) != 0)
+			{
+				event = Event::gone;
+			}
+			else if ((notification->mask & IN_ATTRIB) != 0)
+			{
+				struct stat status{};
+
+				if (::fstat(descriptor_, &status) == 0 and status.st_nlink == 0)
+				{
+					event = Event::gone;
+				}
+			}
+
+			offset += sizeof(inotify_event) + notification->len;
+		}
+	}
+
+	return event;
+}
+} // namespace pcap
@@ -0,0 +1,116 @@
+#ifndef PCAP_FILE_FOLLOWER_HPP
+#define PCAP_FILE_FOLLOWER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stop_token>
+#include <string>
+
+#include "file_reader.hpp"
+#include "pcap/filter/deduplicator.hpp"
+#include "pcap/filter/filter.hpp"
+#include "pcap/packet/packet.hpp"
+
+namespace pcap
+{
+/**
+ * @brief Reader of a capture that is still being written, e.g. by `tcpdump -U -w`.
+ * 
+ * The file is watched with inotify: a reader waiting for packets wakes up as soon as the writer appends data,
+ * records the writer has only partly written are delivered once complete. Following ends when the file has
+ * been moved or deleted and all of its packets were read, when nothing was appended for `idleTimeout` or when
+ * a stop is requested.
+ */
+class FileFollower final
+{
+public:
+	struct Options
+	{
+		// zero waits forever
+		std::chrono::milliseconds idleTimeout{0};
+	};
+
+	using Callback = std::function<void(const Packet& packet)>;
+
+	/**
+	 * @brief Starts watching a file, the file must exist but may still be empty.
+	 * 
+	 * @param fileName File name
+	 */
+	explicit FileFollower(const std::string& fileName);
+	FileFollower(const std::string& fileName, const Options& options);
+	FileFollower(const FileFollower&) = delete;
+	FileFollower(FileFollower&&) = delete;
+	FileFollower& operator=(const FileFollower&) = delete;
+	FileFollower& operator=(FileFollower&&) = delete;
+	~FileFollower();
+
+	/**
+	 * @brief Reads the next packet, waiting for the writer to append one.
+	 * 
+	 * @param packet Packet
+	 * @param token Stop token interrupting the wait
+	 * 
+	 * @return `True` if a packet was read, `false` if following ended
+	 */
+	[[nodiscard]] bool readNextPacket(Packet& packet, std::stop_token token = {});
+
+	/**
+	 * @brief Passes the packets to a callback as they are written, until following ends.
+	 * 
+	 * @param callback Callback receiving the packets
+	 * @param token Stop token ending following
+	 * 
+	 * @return Number of packets passed to the callback
+	 */
+	uint64_t follow(const Callback& callback, std::stop_token token = {});
+
+	/**
+	 * @brief Sets the filter applied to raw packet bytes, see `FileReader::setFilter()`.
+	 * 
+	 * @param filter Compiled packet filter
+	 */
+	void setFilter(Filter filter);
+
+	/**
+	 * @brief Sets the deduplicator applied to the packets accepted by the filter, see `FileReader::setDeduplicator()`.
+	 * 
+	 * @param deduplicator Deduplicator
+	 */
+	void setDeduplicator(Deduplicator deduplicator);
+
+	/**
+	 * @brief Returns the number of packets read, including the ones rejected by the filter.
+	 * 
+	 * @return Number of packets read
+	 */
+	[[nodiscard]] uint64_t readPackets() const noexcept;
+
+private:
+	enum class Event : uint8_t
+	{
+		modified,
+		gone,
+		stopped,
+		idle
+	};
+
+	bool open();
+	Event wait(std::stop_token& token);
+
+	std::string fileName_;
+	Options options_;
+	std::optional<FileReader> reader_;
+	Filter filter_;
+	Deduplicator deduplicator_;
+	int notify_;
+	int wakeup_;
+	// the watched file itself, its link count tells a deletion from other attribute changes
+	int descriptor_;
+	bool gone_;
+};
+} // namespace pcap
+
+#endif // PCAP_FILE_FOLLOWER_HPP
@@ -1,67 +1,171 @@
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <format>
-#include <iostream>
 #include <stdexcept>
+#include <tuple>
+#include <utility>
 
 #include "file_reader.hpp"
 #include "pcap/packet/packet.hpp"
+#include "pcap/packet/packet_batch.hpp"
+#include "pcap/utils/batch_decoder.hpp"
 #include "pcap/utils/byte_swapper.hpp"
+#include "pcap/utils/log.hpp"
+#include "pcap/utils/metrics.hpp"
 
 constexpr uint8_t magicNumberLittleEndianMicroseconds[]{0xd4, 0xc3, 0xb2, 0xa1};
 constexpr uint8_t magicNumberLittleEndianNanoseconds[]{0x4d, 0x3c, 0xb2, 0xa1};
 constexpr uint8_t magicNumberBigEndianMicroseconds[]{0xa1, 0xb2, 0xc3, 0xd4};
 constexpr uint8_t magicNumberBigEndianNanoseconds[]{0xa1, 0xb2, 0x3c, 0x4d};
+// Ethernet header, two VLAN tags, IPv4 header with options and ports
+constexpr uint64_t flowHeadersSize{96};
+// shorter stream skips are read through: seeking drops the stream buffer, which is refilled from the new position
+constexpr uint64_t streamSkipSize{8 * 1024};
 
 namespace pcap
 {
-FileReader::FileReader(const std::string& fileName)
-	: file_(fileName, std::ios::binary)
+FileReader::FileReader(const std::string& fileName) : FileReader(fileName, Options{}) {}
+
+FileReader::FileReader(const std::string& fileName, const Options& options)
+	: mode_{options.mode}
+	, format_{Format::pcap}
+	, follow_{options.follow}
+	, file_{}
+	, mappedFile_{}
+	, source_{}
+	, scratch_{}
+	, pcapng_{}
 	, fileEndian_{std::endian::native}
 	, timestampType_{TimestampType::undefined}
 	, buffer_{}
 	, linkLayerType_{}
 	, fileSize_{}
+	, dataOffset_{}
 	, readBytes_{}
 	, readPackets_{}
+	, index_{}
+	, filter_{}
+	, deduplicator_{}
+	, sampling_{}
+	, pending_{}
+	, pendingOffset_{}
 {
-	if (not file_.is_open())
+	const auto compression{Decompressor::detect(fileName)};
+
+	if (compression != Decompressor::Format::none)
+	{
+		if (not Decompressor::supports(compression))
+		{
+			clear();
+			throw std::runtime_error(std::format("pcap::FileReader [exception]: cannot open '{}': compression format is not supported.", fileName));
+		}
+
+		mode_ = Mode::compressed;
+	}
+
+	if (follow_ and mode_ != Mode::stream)
 	{
 		clear();
-		throw std::runtime_error(std::format("pcap::FileReader [exception]: cannot open '{}': file does not exist.", fileName));
+		throw std::runtime_error(std::format("pcap::FileReader [exception]: cannot follow '{}': only uncompressed files read in stream mode can be followed.", fileName));
+	}
+
+	auto opened{false};
+
+	switch (mode_)
+	{
+	case Mode::memoryMapped:
+		opened = mappedFile_.open(fileName, options.hugePages);
+		fileSize_ = mappedFile_.size();
+		break;
+	case Mode::readAhead:
+	{
+		auto readAhead{std::make_unique<ReadAhead>()};
+		opened = readAhead->open(fileName, options.readAhead);
+		fileSize_ = readAhead->size();
+		source_ = std::move(readAhead);
+		break;
 	}
+	case Mode::compressed:
+	{
+		auto decompressor{std::make_unique<Decompressor>()};
+		opened = decompressor->open(fileName, options.decompression);
+		fileSize_ = decompressor->size();
+		source_ = std::move(decompressor);
+		break;
+	}
+	default:
+		file_.open(fileName, std::ios::binary);
+		opened = file_.is_open();
 
-	std::cout << std::format("pcap::FileReader [info]: file '{}' was successfully opened\n", fileName);
+		if (opened)
+		{
+			file_.seekg(std::ios::beg, std::ios::end);
+			fileSize_ = file_.tellg();
+			file_.seekg(std::ios::beg, std::ios::beg);
+		}
+	}
 
-	file_.seekg(std::ios::beg, std::ios::end);
-	fileSize_ = file_.tellg();
-	file_.seekg(std::ios::beg, std::ios::beg);
+	if (not opened)
+	{
+		clear();
+		throw std::runtime_error(std::format("pcap::FileReader [exception]: cannot open '{}': file does not exist.", fileName));
+	}
 
-	std::cout << std::format("pcap::FileReader [info]: file size {} bytes\n", fileSize_);
+	PCAP_LOG(LogLevel::info, "pcap::FileReader: file '{}' was successfully opened, {} bytes", fileName, fileSize_);
 
 	if (not readFileHeader())
 	{
 		clear();
 		throw std::runtime_error("pcap::FileReader [exception]: file header validation faile: this is not a PCAP file.");
 	}
+
+	if (format_ == Format::pcapng)
+	{
+		// interfaces are usually described before the first packet: learn them now, so index entries can be used right away
+		readMetadata();
+	}
+
+	dataOffset_ = readBytes_;
 }
 
 FileReader::FileReader(FileReader&& reader) noexcept
-	: file_(std::move(reader.file_))
+	: mode_{reader.mode_}
+	, format_{reader.format_}
+	, follow_{reader.follow_}
+	, file_(std::move(reader.file_))
+	, mappedFile_{std::move(reader.mappedFile_)}
+	, source_{std::move(reader.source_)}
+	, scratch_{std::move(reader.scratch_)}
+	, pcapng_{std::move(reader.pcapng_)}
 	, fileEndian_{std::endian::native}
 	, timestampType_{TimestampType::undefined}
 	, buffer_{std::move(reader.buffer_)}
 	, linkLayerType_{}
 	, fileSize_{}
+	, dataOffset_{}
 	, readBytes_{}
 	, readPackets_{}
+	, index_{}
+	, filter_{}
+	, deduplicator_{}
+	, sampling_{}
+	, pending_{}
+	, pendingOffset_{}
 {
 	std::swap(fileEndian_, reader.fileEndian_);
 	std::swap(timestampType_, reader.timestampType_);
 	std::swap(linkLayerType_, reader.linkLayerType_);
 	std::swap(fileSize_, reader.fileSize_);
+	std::swap(dataOffset_, reader.dataOffset_);
 	std::swap(readBytes_, reader.readBytes_);
 	std::swap(readPackets_, reader.readPackets_);
+	std::swap(index_, reader.index_);
+	std::swap(filter_, reader.filter_);
+	std::swap(deduplicator_, reader.deduplicator_);
+	std::swap(sampling_, reader.sampling_);
+	std::swap(pending_, reader.pending_);
+	std::swap(pendingOffset_, reader.pendingOffset_);
 }
 
 FileReader& FileReader::operator=(FileReader&& reader) noexcept
@@ -70,19 +174,38 @@ FileReader& FileReader::operator=(FileReader&& reader) noexcept
 	{
 		clear();
 
+		std::swap(mode_, reader.mode_);
+		std::swap(format_, reader.format_);
+		std::swap(follow_, reader.follow_);
 		std::swap(file_, reader.file_);
+		std::swap(mappedFile_, reader.mappedFile_);
+		std::swap(source_, reader.source_);
+		std::swap(scratch_, reader.scratch_);
+		std::swap(pcapng_, reader.pcapng_);
 		std::swap(fileEndian_, reader.fileEndian_);
 		std::swap(timestampType_, reader.timestampType_);
 		std::swap(buffer_, reader.buffer_);
 		std::swap(linkLayerType_, reader.linkLayerType_);
 		std::swap(fileSize_, reader.fileSize_);
+		std::swap(dataOffset_, reader.dataOffset_);
 		std::swap(readBytes_, reader.readBytes_);
 		std::swap(readPackets_, reader.readPackets_);
+		std::swap(index_, reader.index_);
+		std::swap(filter_, reader.filter_);
+		std::swap(deduplicator_, reader.deduplicator_);
+		std::swap(sampling_, reader.sampling_);
+		std::swap(pending_, reader.pending_);
+		std::swap(pendingOffset_, reader.pendingOffset_);
 	}
 
 	return *this;
 }
 
+FileReader::Mode FileReader::mode() const noexcept
+{
+	return mode_;
+}
+
 uint64_t FileReader::fileSize() const noexcept
 {
 	return fileSize_;
@@ -90,32 +213,321 @@ uint64_t FileReader::fileSize() const noexcept
 
 bool FileReader::readNextPacket(Packet& packet)
 {
-	if (readBytes_ == fileSize_)
+	while (true)
+	{
+		const auto offset{pending_ ? pendingOffset_ : readBytes_};
+		const auto record{pending_ ? std::exchange(pending_, std::nullopt) : readRecord()};
+
+		if (not record)
+		{
+			return false;
+		}
+
+		const auto dataOffset{readBytes_};
+
+		switch (select(*record))
+		{
+		case Selection::skip:
+			// the flow selection may have read the first bytes of the packet already
+			skip(dataOffset + record->currentLength + record->trailerLength - readBytes_);
+			++readPackets_;
+			continue;
+		case Selection::end:
+			// the record is kept for a later window instead of seeking back to it, which would decompress
+			// the stream again or drop the blocks read ahead
+			pending_ = record;
+			pendingOffset_ = offset;
+			return false;
+		default:
+			break;
+		}
+
+		// packets selected by their flow are already in the scratch buffer in `Mode::stream`
+		const auto data{readBytes_ == dataOffset ? readData(*record) : std::span<const uint8_t>{scratch_.data(), record->currentLength}};
+		++readPackets_;
+
+		// rejected packets and duplicates are skipped on their raw bytes, before any packet work
+		if (not filter_(data, record->linkLayerType) or deduplicator_.isDuplicate(data, record->linkLayerType, record->timestamp.count()))
+		{
+			continue;
+		}
+
+		packet.fill(record->timestamp, record->linkLayerType, data);
+
+		// stream packets own their bytes: they are copied into the packet storage, which is reused
+		if (mode_ == Mode::stream)
+		{
+			packet.own();
+		}
+
+		return true;
+	}
+}
+
+bool FileReader::readBatch(PacketBatch& batch, uint64_t count)
+{
+	batch.clear();
+
+	if (count == 0)
 	{
 		return false;
 	}
 
-	const auto packetHeader{readPacketHeader()};
+	// only the header of the record that ended a sampling window has been read
+	if (pending_)
+	{
+		rewind(pendingOffset_, readPackets_);
+	}
 
-	if (not packetHeader)
+	if (source_)
 	{
-		clear();
-		throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet header: file corrupted");
+		return readBatchAhead(batch, count);
 	}
 
-	buffer_.overwrite(file_, packetHeader->currentLength);
+	while (not atEnd())
+	{
+		std::span<const uint8_t> data{};
+
+		if (mode_ == Mode::memoryMapped)
+		{
+			data = mappedFile_.data().subspan(readBytes_, std::min<uint64_t>(fileSize_ - readBytes_, UINT32_MAX));
+		}
+		else
+		{
+			auto readSize{std::min(batch.arenaSize_, fileSize_ - readBytes_)};
+			PCAP_METRICS(const auto start{std::chrono::steady_clock::now()});
+			data = {batch.arena_.get(), static_cast<size_t>(file_.read(reinterpret_cast<char*>(batch.arena_.get()), readSize).gcount())};
+			PCAP_METRICS(Metrics::recordRead(std::chrono::steady_clock::now() - start, data.size()));
+		}
 
-	readBytes_ += packetHeader->currentLength;
-	++readPackets_;
+		uint64_t offset{};
+		uint64_t packets{};
 
-	const auto packetTimestamp{
-		std::chrono::seconds{packetHeader->timestampSec} + (timestampType_ == TimestampType::nanoseconds ?
-									    std::chrono::nanoseconds{packetHeader->timestampMicrosec} :
-									    std::chrono::microseconds{packetHeader->timestampMicrosec})};
+		while (batch.size() < count)
+		{
+			const auto size{recordSize(data.subspan(offset))};
 
-	packet.fill(std::chrono::duration_cast<std::chrono::nanoseconds>(packetTimestamp), linkLayerType_, buffer_);
+			if (size == 0 or data.size() - offset < size)
+			{
+				break;
+			}
 
-	return true;
+			packets += pushRecord(batch, data.subspan(offset, size), offset, readBytes_ + offset);
+			offset += size;
+		}
+
+		if (mode_ == Mode::stream)
+		{
+			// the tail holds an incomplete record: step back so the next read starts from its header
+			file_.seekg(-static_cast<std::streamoff>(data.size() - offset), std::ios::cur);
+		}
+
+		if (offset == 0)
+		{
+			if (mode_ == Mode::stream and data.size() == batch.arenaSize_ and recordSize(data) > data.size())
+			{
+				// a single record does not fit into the arena: grow it and retry
+				batch.reserveArena(recordSize(data));
+				continue;
+			}
+
+			// the writer has not finished the record yet
+			if (follow_)
+			{
+				return false;
+			}
+
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet header: file corrupted");
+		}
+
+		readBytes_ += offset;
+		readPackets_ += packets;
+
+		// otherwise only pcapng metadata blocks or filtered out packets were read
+		if (not batch.empty())
+		{
+			batch.data_ = data.first(offset);
+			decodeHeaders(batch);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FileReader::setFilter(Filter filter) noexcept
+{
+	filter_ = std::move(filter);
+}
+
+void FileReader::setDeduplicator(Deduplicator deduplicator) noexcept
+{
+	deduplicator_ = std::move(deduplicator);
+}
+
+void FileReader::setSampling(const Sampling& sampling) noexcept
+{
+	sampling_ = sampling;
+	sampling_.packets = std::max<uint64_t>(sampling_.packets, 1);
+	sampling_.flows = std::max<uint64_t>(sampling_.flows, 1);
+}
+
+void FileReader::useIndex(PacketIndex index)
+{
+	if (index.fileSize() != fileSize_)
+	{
+		throw std::runtime_error("pcap::FileReader [exception]: packet index does not match the file");
+	}
+
+	index_ = std::move(index);
+}
+
+bool FileReader::seek(uint64_t packetNumber)
+{
+	const auto* entry{index_.findPacket(packetNumber)};
+
+	if (entry and entry->packetNumber <= packetNumber)
+	{
+		rewind(entry->offset, entry->packetNumber);
+	}
+	else
+	{
+		rewind(dataOffset_, 0);
+	}
+
+	while (readPackets_ < packetNumber)
+	{
+		const auto record{readRecord()};
+
+		if (not record)
+		{
+			return false;
+		}
+
+		skip(record->currentLength + record->trailerLength);
+		++readPackets_;
+	}
+
+	// pcapng metadata blocks may still follow the last packet
+	return format_ == Format::pcapng ? readMetadata().has_value() : not atEnd();
+}
+
+bool FileReader::seekTime(uint64_t timestamp)
+{
+	const auto* entry{index_.findTime(timestamp)};
+
+	if (entry)
+	{
+		rewind(entry->offset, entry->packetNumber);
+	}
+	else
+	{
+		rewind(dataOffset_, 0);
+	}
+
+	while (true)
+	{
+		if (format_ == Format::pcapng)
+		{
+			readMetadata();
+		}
+
+		const auto offset{readBytes_};
+		const auto record{readRecord()};
+
+		if (not record)
+		{
+			return false;
+		}
+
+		if (static_cast<uint64_t>(record->timestamp.count()) >= timestamp)
+		{
+			rewind(offset, readPackets_);
+			return true;
+		}
+
+		skip(record->currentLength + record->trailerLength);
+		++readPackets_;
+	}
+}
+
+bool FileReader::readBatchAhead(PacketBatch& batch, uint64_t count)
+{
+	uint64_t offset{};
+	uint64_t readBytes{};
+	uint64_t packets{};
+
+	// source blocks already hold the data: copy whole records into the arena without any system calls
+	while (batch.size() < count and not source_->eof())
+	{
+		uint8_t header[sizeof(PacketHeader)]{};
+		const auto headerSize{format_ == Format::pcapng ? PcapngDecoder::minimumBlockSize : sizeof(PacketHeader)};
+
+		if (source_->peek(header, headerSize) != headerSize)
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet header: file corrupted");
+		}
+
+		const auto size{recordSize({header, headerSize})};
+
+		if (batch.arenaSize_ - offset < size)
+		{
+			if (not batch.empty())
+			{
+				break;
+			}
+
+			// only pcapng metadata blocks or filtered out packets are in the arena so far, they are not needed anymore
+			offset = 0;
+			batch.reserveArena(size);
+		}
+
+		if (source_->read(batch.arena_.get() + offset, size) != size)
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet data: file corrupted");
+		}
+
+		packets += pushRecord(batch, {batch.arena_.get() + offset, static_cast<size_t>(size)}, offset, readBytes_ + readBytes);
+		offset += size;
+		readBytes += size;
+	}
+
+	batch.data_ = {batch.arena_.get(), static_cast<size_t>(offset)};
+	decodeHeaders(batch);
+	readBytes_ += readBytes;
+	readPackets_ += packets;
+
+	return not batch.empty();
+}
+
+bool FileReader::refresh()
+{
+	if (not follow_)
+	{
+		return false;
+	}
+
+	// end of file flags are set by reads at the former end
+	file_.clear();
+
+	const auto position{file_.tellg()};
+	file_.seekg(0, std::ios::end);
+	const auto size{static_cast<uint64_t>(file_.tellg())};
+	file_.seekg(position);
+
+	if (size < readBytes_)
+	{
+		clear();
+		throw std::runtime_error("pcap::FileReader [exception]: cannot follow file: file truncated");
+	}
+
+	const auto grown{size > fileSize_};
+	fileSize_ = size;
+
+	return grown;
 }
 
 uint64_t FileReader::readBytes() const noexcept
@@ -128,10 +540,40 @@ uint64_t FileReader::readPackets() const noexcept
 	return readPackets_;
 }
 
-bool FileReader::readFileHeader() noexcept
+uint64_t FileReader::duplicatePackets() const noexcept
+{
+	return deduplicator_.duplicates();
+}
+
+bool FileReader::readFileHeader()
 {
 	uint8_t buffer[sizeof(FileHeader)]{};
-	readBytes_ += file_.read(reinterpret_cast<char*>(buffer), sizeof(FileHeader)).gcount();
+	readBytes_ += read(buffer, sizeof(FileHeader));
+
+	if (PcapngDecoder::isSectionHeader({buffer, readBytes_}))
+	{
+		const auto header{pcapng_.blockHeader({buffer, readBytes_})};
+
+		if (header.length < sizeof(PcapngDecoder::SectionHeaderBlock) + sizeof(uint32_t) or
+		    (mode_ != Mode::compressed and header.length > fileSize_))
+		{
+			return false;
+		}
+
+		scratch_.resize(header.length);
+		std::memcpy(scratch_.data(), buffer, sizeof(FileHeader));
+		readBytes_ += read(scratch_.data() + sizeof(FileHeader), header.length - sizeof(FileHeader));
+
+		if (readBytes_ != header.length or not pcapng_.metadata(scratch_, 0))
+		{
+			return false;
+		}
+
+		format_ = Format::pcapng;
+		fileEndian_ = pcapng_.endian();
+
+		return true;
+	}
 
 	if (not validateFileHeader({buffer, readBytes_}))
 	{
@@ -147,7 +589,11 @@ bool FileReader::readFileHeader() noexcept
 	ByteSwapper{}(header, fileEndian_);
 
 	linkLayerType_ = header.linkLayerType;
-	buffer_.reserve(header.snapLength);
+
+	if (mode_ == Mode::stream)
+	{
+		buffer_.reserve(header.snapLength);
+	}
 
 	return true;
 }
@@ -155,7 +601,7 @@ bool FileReader::readFileHeader() noexcept
 std::optional<FileReader::PacketHeader> FileReader::readPacketHeader() noexcept
 {
 	PacketHeader header{};
-	const auto curReadBytes{file_.read(reinterpret_cast<char*>(&header), sizeof(PacketHeader)).gcount()};
+	const auto curReadBytes{read(&header, sizeof(PacketHeader))};
 
 	if (curReadBytes != sizeof(PacketHeader))
 	{
@@ -169,16 +615,465 @@ std::optional<FileReader::PacketHeader> FileReader::readPacketHeader() noexcept
 	return header;
 }
 
+std::optional<FileReader::Record> FileReader::readRecord()
+{
+	if (format_ == Format::pcap)
+	{
+		if (atEnd() or (follow_ and fileSize_ - readBytes_ < sizeof(PacketHeader)))
+		{
+			return std::nullopt;
+		}
+
+		const auto packetHeader{readPacketHeader()};
+
+		if (not packetHeader)
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet header: file corrupted");
+		}
+
+		// only a part of the record has been written yet: it is read again once complete
+		if (follow_ and packetHeader->currentLength > fileSize_ - readBytes_)
+		{
+			rewind(readBytes_ - sizeof(PacketHeader), readPackets_);
+			return std::nullopt;
+		}
+
+		return Record{timestamp(*packetHeader), linkLayerType_, packetHeader->currentLength, packetHeader->orignalLength, 0};
+	}
+
+	const auto header{readMetadata()};
+
+	if (not header)
+	{
+		return std::nullopt;
+	}
+
+	uint8_t prefix[sizeof(PcapngDecoder::EnhancedPacketBlock)]{};
+	const auto prefixSize{PcapngDecoder::packetPrefixSize(header->type)};
+	Record record{};
+
+	if (header->length < prefixSize + sizeof(uint32_t) or read(prefix, prefixSize) != prefixSize or
+	    not pcapng_.packet(*header, {prefix, prefixSize}, record))
+	{
+		clear();
+		throw std::runtime_error("pcap::FileReader [exception]: cannot read pcapng packet block: file corrupted");
+	}
+
+	readBytes_ += prefixSize;
+
+	return record;
+}
+
+std::optional<PcapngDecoder::BlockHeader> FileReader::readMetadata()
+{
+	while (not atEnd())
+	{
+		uint8_t buffer[PcapngDecoder::minimumBlockSize]{};
+		const auto header{pcapng_.blockHeader({buffer, static_cast<size_t>(peek(buffer, sizeof(buffer)))})};
+
+		// only a part of the block has been written yet: it is read again once complete
+		if (follow_ and (fileSize_ - readBytes_ < sizeof(buffer) or (header.length != 0 and header.length > fileSize_ - readBytes_)))
+		{
+			return std::nullopt;
+		}
+
+		if (header.length == 0 or (mode_ != Mode::compressed and header.length > fileSize_ - readBytes_))
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read pcapng block header: file corrupted");
+		}
+
+		if (PcapngDecoder::packetPrefixSize(header.type) != 0)
+		{
+			return header;
+		}
+
+		if (header.type != PcapngDecoder::sectionHeader and header.type != PcapngDecoder::interfaceDescription)
+		{
+			// statistics, name resolution, custom and unknown blocks
+			skip(header.length);
+			continue;
+		}
+
+		const auto offset{readBytes_};
+		scratch_.resize(header.length);
+
+		if (read(scratch_.data(), header.length) != header.length)
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read pcapng block: file corrupted");
+		}
+
+		readBytes_ += header.length;
+
+		if (not pcapng_.metadata(scratch_, offset))
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read pcapng block: file corrupted");
+		}
+
+		fileEndian_ = pcapng_.endian();
+	}
+
+	return std::nullopt;
+}
+
+std::span<const uint8_t> FileReader::readData(const Record& record)
+{
+	// pcapng blocks end with padding, options and the trailing block length
+	const uint64_t size{record.currentLength + record.trailerLength};
+
+	if (mode_ == Mode::memoryMapped)
+	{
+		if (fileSize_ - readBytes_ < size)
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet data: file corrupted");
+		}
+
+		const auto data{mappedFile_.data().subspan(readBytes_, record.currentLength)};
+		readBytes_ += size;
+
+		return data;
+	}
+	else if (source_)
+	{
+		// the trailer is viewed together with the data: skipping it separately could release the block the data refers to
+		const auto data{source_->view(size, scratch_)};
+
+		if (data.size() != size)
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet data: file corrupted");
+		}
+
+		readBytes_ += size;
+
+		return data.first(record.currentLength);
+	}
+
+	buffer_.overwrite(file_, record.currentLength);
+	readBytes_ += record.currentLength;
+
+	if (record.trailerLength != 0)
+	{
+		skip(record.trailerLength);
+	}
+
+	return buffer_.data();
+}
+
+FileReader::Selection FileReader::select(const Record& record)
+{
+	const auto timestamp{static_cast<uint64_t>(record.timestamp.count())};
+
+	if (timestamp >= sampling_.end)
+	{
+		return Selection::end;
+	}
+
+	if (timestamp < sampling_.begin or (sampling_.packets > 1 and readPackets_ % sampling_.packets != 0))
+	{
+		return Selection::skip;
+	}
+
+	if (sampling_.flows > 1)
+	{
+		uint8_t buffer[flowHeadersSize]{};
+		auto* headers{buffer};
+		auto headersSize{std::min<uint64_t>(record.currentLength, flowHeadersSize)};
+
+		// stepping back in a stream drops its buffer: the headers are read into the scratch buffer instead,
+		// where the rest of a selected packet joins them
+		if (mode_ == Mode::stream)
+		{
+			scratch_.resize(record.currentLength);
+			headers = scratch_.data();
+
+			if (read(headers, headersSize) != headersSize)
+			{
+				clear();
+				throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet data: file corrupted");
+			}
+
+			readBytes_ += headersSize;
+		}
+		else
+		{
+			headersSize = peek(headers, headersSize);
+		}
+
+		auto tuple{extractFiveTuple({headers, static_cast<size_t>(headersSize)}, record.linkLayerType)};
+
+		// both directions hash alike
+		if (std::tie(tuple.sourceAddress, tuple.sourcePort) > std::tie(tuple.destinationAddress, tuple.destinationPort))
+		{
+			std::swap(tuple.sourceAddress, tuple.destinationAddress);
+			std::swap(tuple.sourcePort, tuple.destinationPort);
+		}
+
+		if (std::hash<FiveTuple>{}(tuple) % sampling_.flows != 0)
+		{
+			return Selection::skip;
+		}
+
+		if (mode_ == Mode::stream)
+		{
+			const auto restSize{record.currentLength - headersSize};
+
+			if (read(scratch_.data() + headersSize, restSize) != restSize)
+			{
+				clear();
+				throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet data: file corrupted");
+			}
+
+			readBytes_ += restSize;
+
+			if (record.trailerLength != 0)
+			{
+				skip(record.trailerLength);
+			}
+		}
+	}
+
+	return Selection::read;
+}
+
+uint64_t FileReader::read(void* data, uint64_t size) noexcept
+{
+	if (mode_ == Mode::memoryMapped)
+	{
+		size = std::min(size, fileSize_ - readBytes_);
+		std::memcpy(data, mappedFile_.data().data() + readBytes_, size);
+
+		return size;
+	}
+
+	if (source_)
+	{
+		return source_->read(data, size);
+	}
+
+	return file_.read(static_cast<char*>(data), size).gcount();
+}
+
+uint64_t FileReader::peek(void* data, uint64_t size)
+{
+	if (mode_ == Mode::stream)
+	{
+		const auto readSize{file_.read(static_cast<char*>(data), size).gcount()};
+		file_.clear();
+		file_.seekg(-readSize, std::ios::cur);
+
+		return readSize;
+	}
+
+	if (source_)
+	{
+		return source_->peek(data, size);
+	}
+
+	return read(data, size);
+}
+
+uint64_t FileReader::recordSize(std::span<const uint8_t> data)
+{
+	if (format_ == Format::pcapng)
+	{
+		if (data.size() < PcapngDecoder::minimumBlockSize)
+		{
+			return 0;
+		}
+
+		const auto header{pcapng_.blockHeader(data)};
+
+		if (header.length == 0)
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read pcapng block header: file corrupted");
+		}
+
+		return header.length;
+	}
+
+	if (data.size() < sizeof(PacketHeader))
+	{
+		return 0;
+	}
+
+	PacketHeader header{};
+	std::memcpy(&header, data.data(), sizeof(PacketHeader));
+	ByteSwapper{}(header, fileEndian_);
+
+	return sizeof(PacketHeader) + header.currentLength;
+}
+
+uint64_t FileReader::pushRecord(PacketBatch& batch, std::span<const uint8_t> data, uint64_t offset, uint64_t fileOffset)
+{
+	if (format_ == Format::pcap)
+	{
+		const auto packet{data.subspan(sizeof(PacketHeader))};
+
+		if (not filter_(packet, linkLayerType_))
+		{
+			return 1;
+		}
+
+		if (not deduplicator_.empty())
+		{
+			PacketHeader header{};
+			std::memcpy(&header, data.data(), sizeof(PacketHeader));
+			ByteSwapper{}(header, fileEndian_);
+
+			if (deduplicator_.isDuplicate(packet, linkLayerType_, timestamp(header).count()))
+			{
+				return 1;
+			}
+		}
+
+		// the headers are decoded all at once by the batch when the walk is over
+		batch.push(0, offset + sizeof(PacketHeader), 0, 0, linkLayerType_);
+
+		return 1;
+	}
+
+	const auto header{pcapng_.blockHeader(data)};
+
+	if (const auto prefixSize{PcapngDecoder::packetPrefixSize(header.type)})
+	{
+		Record record{};
+
+		if (not pcapng_.packet(header, data.first(std::min<uint64_t>(prefixSize, data.size())), record))
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read pcapng packet block: file corrupted");
+		}
+
+		const auto packet{data.subspan(prefixSize, record.currentLength)};
+
+		if (filter_(packet, record.linkLayerType) and not deduplicator_.isDuplicate(packet, record.linkLayerType, record.timestamp.count()))
+		{
+			batch.push(record.timestamp.count(), offset + prefixSize, record.currentLength, record.originalLength, record.linkLayerType);
+		}
+
+		return 1;
+	}
+
+	if (not pcapng_.metadata(data, fileOffset))
+	{
+		clear();
+		throw std::runtime_error("pcap::FileReader [exception]: cannot read pcapng block: file corrupted");
+	}
+
+	fileEndian_ = pcapng_.endian();
+
+	return 0;
+}
+
+void FileReader::decodeHeaders(PacketBatch& batch) const noexcept
+{
+	if (format_ == Format::pcap)
+	{
+		batch.decodeHeaders(fileEndian_, timestampType_ == TimestampType::nanoseconds);
+	}
+}
+
+std::chrono::nanoseconds FileReader::timestamp(const PacketHeader& header) const noexcept
+{
+	const auto packetTimestamp{
+		std::chrono::seconds{header.timestampSec} + (timestampType_ == TimestampType::nanoseconds ?
+								     std::chrono::nanoseconds{header.timestampMicrosec} :
+								     std::chrono::microseconds{header.timestampMicrosec})};
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(packetTimestamp);
+}
+
+bool FileReader::atEnd()
+{
+	// the uncompressed size is unknown until the whole stream is decompressed
+	return mode_ == Mode::compressed ? source_->eof() : readBytes_ == fileSize_;
+}
+
+void FileReader::rewind(uint64_t offset, uint64_t packets)
+{
+	pending_.reset();
+
+	if (mode_ != Mode::compressed and offset > fileSize_)
+	{
+		clear();
+		throw std::runtime_error("pcap::FileReader [exception]: cannot seek past the end of file: file corrupted");
+	}
+
+	if (mode_ == Mode::stream)
+	{
+		file_.clear();
+		file_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	}
+	else if (source_)
+	{
+		source_->seek(offset);
+	}
+
+	readBytes_ = offset;
+	readPackets_ = packets;
+}
+
+void FileReader::skip(uint64_t size)
+{
+	if (source_)
+	{
+		if (source_->skip(size) != size)
+		{
+			clear();
+			throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet data: file corrupted");
+		}
+
+		readBytes_ += size;
+		return;
+	}
+
+	if (fileSize_ - readBytes_ < size)
+	{
+		clear();
+		throw std::runtime_error("pcap::FileReader [exception]: cannot read PCAP packet data: file corrupted");
+	}
+
+	if (mode_ == Mode::stream)
+	{
+		if (size < streamSkipSize)
+		{
+			file_.ignore(static_cast<std::streamsize>(size));
+		}
+		else
+		{
+			file_.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+		}
+	}
+
+	readBytes_ += size;
+}
+
 void FileReader::clear()
 {
 	file_.close();
+	mappedFile_.close();
+	source_.reset();
+	pcapng_ = {};
 	fileEndian_ = std::endian::native;
 	timestampType_ = TimestampType::undefined;
 	buffer_.destroy();
 	linkLayerType_ = 0;
 	fileSize_ = 0;
+	dataOffset_ = 0;
 	readBytes_ = 0;
 	readPackets_ = 0;
+	index_ = {};
+	filter_ = {};
+	deduplicator_ = {};
+	sampling_ = {};
+	pending_.reset();
+	pendingOffset_ = 0;
 }
 
 bool FileReader::validateFileHeader(std::span<const uint8_t> data) noexcept
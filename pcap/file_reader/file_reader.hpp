@@ -2,17 +2,31 @@
 #define PCAP_FILE_READER_HPP
 
 #include <bit>
+#include <chrono>
 #include <fstream>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <vector>
 
 #include "byte_buffer/byte_buffer.hpp"
+#include "pcapng_decoder.hpp"
+#include "pcap/filter/deduplicator.hpp"
+#include "pcap/filter/filter.hpp"
+#include "pcap/index/packet_index.hpp"
+#include "pcap/utils/decompressor.hpp"
+#include "pcap/utils/mapped_file.hpp"
+#include "pcap/utils/read_ahead.hpp"
 
 namespace pcap
 {
 class Packet;
+class PacketBatch;
 
+/**
+ * @brief Reader of PCAP and pcapng files, the format is detected from the file header.
+ */
 class FileReader final
 {
 public:
@@ -37,14 +51,67 @@ public:
 	};
 #pragma pack(pop)
 
+	enum class Mode : uint8_t
+	{
+		// packets are read through `std::ifstream` and own a copy of their bytes
+		stream,
+		// the file is mapped into memory and packets refer to the mapping: no copies, no allocations,
+		// packet data stays valid as long as the reader is alive
+		memoryMapped,
+		// large reads are issued ahead of parsing (io_uring or a `pread()` thread),
+		// packet data stays valid until the next read
+		readAhead,
+		// selected automatically for gzip, zstd and lz4 files: decompression runs on its own thread,
+		// packet data stays valid until the next read
+		compressed
+	};
+
+	/**
+	 * @brief Packets selected by `readNextPacket()` on their record headers, the payloads of the others are skipped
+	 * without being read. This saves the payload I/O in `Mode::stream` and `Mode::memoryMapped`, other modes read
+	 * whole blocks anyway.
+	 */
+	struct Sampling
+	{
+		// every `packets`-th packet of the file, starting from the first one
+		uint64_t packets{1};
+		// every `flows`-th flow by the hash of its 5-tuple, both directions alike: only the first bytes of the payload are read,
+		// packets without a 5-tuple make up a single flow
+		uint64_t flows{1};
+		// packets in [begin, end) `nanoseconds`, assuming packets are stored in time order: reading ends at the first packet
+		// not older than `end`, which is kept without seeking back, so a later window resumes from it.
+		// With an index `seekTime(begin)` skips the packets before the window too.
+		uint64_t begin{0};
+		uint64_t end{UINT64_MAX};
+	};
+
+	struct Options
+	{
+		Mode mode{Mode::stream};
+		bool hugePages{false};
+		ReadAhead::Options readAhead{};
+		Decompressor::Options decompression{};
+		// the file is still being written, `Mode::stream` only: an incomplete trailing record ends reading
+		// like the end of file instead of being reported as corruption, `refresh()` picks up appended data
+		bool follow{false};
+	};
+
 	explicit FileReader(const std::string& fileName);
+	FileReader(const std::string& fileName, const Options& options);
 	FileReader(const FileReader&) = delete;
 	FileReader(FileReader&&) noexcept;
 	FileReader& operator=(const FileReader&) = delete;
 	FileReader& operator=(FileReader&&) noexcept;
 
 	/**
-	 * @brief Returns the file size.
+	 * @brief Returns the mode the file is read in, `Mode::compressed` for compressed files whatever mode was requested.
+	 * 
+	 * @return Reading mode
+	 */
+	[[nodiscard]] Mode mode() const noexcept;
+
+	/**
+	 * @brief Returns the file size, for compressed files - the compressed size.
 	 * 
 	 * @return File size
 	 */
@@ -59,6 +126,77 @@ public:
 	 */
 	[[nodiscard]] bool readNextPacket(Packet& packet);
 
+	/**
+	 * @brief Reads up to `count` next packets from the file with a single large read into the batch arena.
+	 * 
+	 * In `Mode::memoryMapped` the batch refers to the mapping and no data is copied.
+	 * 
+	 * @param batch Packet batch, its previous contents are discarded
+	 * @param count Maximum number of packets to read
+	 * 
+	 * @return `True` if at least one packet was read, otherwise - `false`
+	 */
+	[[nodiscard]] bool readBatch(PacketBatch& batch, uint64_t count);
+
+	/**
+	 * @brief Sets the filter applied by `readNextPacket()` and `readBatch()` to raw packet bytes:
+	 * rejected packets are skipped before any packet work. `seek()` and `seekTime()` ignore the filter.
+	 * 
+	 * @param filter Compiled packet filter, an empty filter accepts every packet
+	 */
+	void setFilter(Filter filter) noexcept;
+
+	/**
+	 * @brief Sets the deduplicator applied by `readNextPacket()` and `readBatch()` to the packets accepted by the filter:
+	 * duplicates are skipped on their raw bytes like rejected packets.
+	 * 
+	 * @param deduplicator Deduplicator, an empty one keeps every packet
+	 */
+	void setDeduplicator(Deduplicator deduplicator) noexcept;
+
+	/**
+	 * @brief Sets the packets `readNextPacket()` selects before the filter, skipped packets are counted as read.
+	 * 
+	 * @param sampling Sampling, a default one selects every packet
+	 */
+	void setSampling(const Sampling& sampling) noexcept;
+
+	/**
+	 * @brief Sets the packet index used by `seek()` and `seekTime()`.
+	 * 
+	 * @param index Packet index built for this file
+	 */
+	void useIndex(PacketIndex index);
+
+	/**
+	 * @brief Positions the reader at a packet, so the next read returns it.
+	 * 
+	 * Without an index the file is scanned from the beginning, with an index only from the nearest sampled packet.
+	 * Only packet headers are read while scanning. `readPackets()` becomes the packet number.
+	 * In pcapng files interfaces described after the first packet are not known when an index entry skips past them.
+	 * 
+	 * @param packetNumber Packet number, starting from `0`
+	 * 
+	 * @return `True` if the packet exists, otherwise - `false`
+	 */
+	[[nodiscard]] bool seek(uint64_t packetNumber);
+
+	/**
+	 * @brief Positions the reader at the first packet not older than a point in time, assuming packets are stored in time order.
+	 * 
+	 * @param timestamp Timestamp `nanoseconds`
+	 * 
+	 * @return `True` if such packet exists, otherwise - `false`
+	 */
+	[[nodiscard]] bool seekTime(uint64_t timestamp);
+
+	/**
+	 * @brief Picks up the data appended to a followed file since the last call.
+	 * 
+	 * @return `True` if the file has grown, otherwise - `false`
+	 */
+	bool refresh();
+
 	/**
 	 * @brief Returns the number of bytes read.
 	 * 
@@ -67,13 +205,23 @@ public:
 	[[nodiscard]] uint64_t readBytes() const noexcept;
 
 	/**
-	 * @brief Returns the number of packets read.
+	 * @brief Returns the number of packets read, including the ones rejected by the filter and the duplicates.
 	 * 
 	 * @return Number of packets read 
 	 */
 	[[nodiscard]] uint64_t readPackets() const noexcept;
 
+	/**
+	 * @brief Returns the number of duplicates skipped.
+	 * 
+	 * @return Number of duplicates
+	 */
+	[[nodiscard]] uint64_t duplicatePackets() const noexcept;
+
 private:
+	// shares the file header decoding
+	friend class AsyncFileReader;
+
 	enum TimestampType : int8_t
 	{
 		undefined,
@@ -81,22 +229,67 @@ private:
 		microseconds
 	};
 
-	bool readFileHeader() noexcept;
+	enum class Format : uint8_t
+	{
+		pcap,
+		pcapng
+	};
+
+	enum class Selection : uint8_t
+	{
+		read,
+		skip,
+		end
+	};
+
+	using Record = PcapngDecoder::Record;
+
+	bool readFileHeader();
 	std::optional<PacketHeader> readPacketHeader() noexcept;
+	std::optional<Record> readRecord();
+	std::optional<PcapngDecoder::BlockHeader> readMetadata();
+	std::span<const uint8_t> readData(const Record& record);
+	Selection select(const Record& record);
+	uint64_t read(void* data, uint64_t size) noexcept;
+	uint64_t peek(void* data, uint64_t size);
+	bool readBatchAhead(PacketBatch& batch, uint64_t count);
+	uint64_t recordSize(std::span<const uint8_t> data);
+	uint64_t pushRecord(PacketBatch& batch, std::span<const uint8_t> data, uint64_t offset, uint64_t fileOffset);
+	void decodeHeaders(PacketBatch& batch) const noexcept;
+	std::chrono::nanoseconds timestamp(const PacketHeader& header) const noexcept;
+	bool atEnd();
+	void rewind(uint64_t offset, uint64_t packets);
+	void skip(uint64_t size);
 	void clear();
 	
 	static bool validateFileHeader(std::span<const uint8_t> data) noexcept;
 	static std::endian getFileEndian(uint8_t byte) noexcept;
 	static TimestampType getTimestampType(uint8_t byte) noexcept;
 
+	Mode mode_;
+	Format format_;
+	bool follow_;
 	std::ifstream file_;
+	MappedFile mappedFile_;
+	std::unique_ptr<BlockSource> source_;
+	std::vector<uint8_t> scratch_;
+	PcapngDecoder pcapng_;
 	std::endian fileEndian_;
 	TimestampType timestampType_;
 	byte_buffer::ByteBuffer buffer_;
 	uint32_t linkLayerType_;
 	uint64_t fileSize_;
+	uint64_t dataOffset_;
 	uint64_t readBytes_;
 	uint64_t readPackets_;
+	PacketIndex index_;
+	Filter filter_;
+	Deduplicator deduplicator_;
+	Sampling sampling_;
+	// record whose timestamp ended the sampling window, its data is not read yet
+	std::optional<Record> pending_;
+	// file offset the record was read from
+	uint64_t pendingOffset_;
 };
 } // namespace pcap
 
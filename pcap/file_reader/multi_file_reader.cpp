@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include "multi_file_reader.hpp"
+#include "pcap/packet/packet.hpp"
+
+constexpr uint64_t noInput{UINT64_MAX};
+
+namespace pcap
+{
+MultiFileReader::MultiFileReader(const std::vector<std::string>& fileNames) : MultiFileReader(fileNames, Options{}) {}
+
+MultiFileReader::MultiFileReader(const std::vector<std::string>& fileNames, const Options& options)
+	: inputs_{}
+	, heap_{}
+	, options_{options}
+	, readPackets_{}
+	, current_{noInput}
+	, started_{}
+{
+	options_.batchPackets = std::max<uint64_t>(1, options_.batchPackets);
+	inputs_.reserve(fileNames.size());
+	heap_.reserve(fileNames.size());
+
+	for (const auto& fileName : fileNames)
+	{
+		inputs_.push_back(Input{FileReader{fileName, options_.reader}, PacketBatch{options_.arenaSize}, 0});
+	}
+}
+
+bool MultiFileReader::readNextPacket(Packet& packet)
+{
+	if (not started_)
+	{
+		for (uint64_t i{}; i < inputs_.size(); ++i)
+		{
+			schedule(i);
+		}
+
+		started_ = true;
+	}
+
+	if (current_ != noInput)
+	{
+		++inputs_[current_].position;
+		schedule(current_);
+		current_ = noInput;
+	}
+
+	if (heap_.empty())
+	{
+		return false;
+	}
+
+	std::pop_heap(heap_.begin(), heap_.end(), later);
+	current_ = heap_.back().input;
+	heap_.pop_back();
+
+	const auto& input{inputs_[current_]};
+	input.batch.packet(input.position, packet);
+	++readPackets_;
+
+	return true;
+}
+
+bool MultiFileReader::seekTime(uint64_t timestamp)
+{
+	heap_.clear();
+	current_ = noInput;
+	started_ = true;
+
+	for (uint64_t i{}; i < inputs_.size(); ++i)
+	{
+		auto& input{inputs_[i]};
+		input.batch.clear();
+		input.position = 0;
+
+		if (input.reader.seekTime(timestamp))
+		{
+			schedule(i);
+		}
+	}
+
+	return not heap_.empty();
+}
+
+void MultiFileReader::setFilter(const Filter& filter)
+{
+	for (auto& input : inputs_)
+	{
+		input.reader.setFilter(filter);
+	}
+}
+
+uint64_t MultiFileReader::readPackets() const noexcept
+{
+	return readPackets_;
+}
+
+uint64_t MultiFileReader::size() const noexcept
+{
+	return inputs_.size();
+}
+
+void MultiFileReader::schedule(uint64_t index)
+{
+	auto& input{inputs_[index]};
+
+	if (input.position == input.batch.size())
+	{
+		input.position = 0;
+
+		if (not input.reader.readBatch(input.batch, options_.batchPackets))
+		{
+			return;
+		}
+	}
+
+	heap_.push_back(HeapEntry{input.batch.timestamps()[input.position], index});
+	std::push_heap(heap_.begin(), heap_.end(), later);
+}
+
+bool MultiFileReader::later(const HeapEntry& first, const HeapEntry& second) noexcept
+{
+	return first.timestamp > second.timestamp or (first.timestamp == second.timestamp and first.input > second.input);
+}
+} // namespace pcap
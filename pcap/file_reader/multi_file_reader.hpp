@@ -0,0 +1,109 @@
+#ifndef PCAP_MULTI_FILE_READER_HPP
+#define PCAP_MULTI_FILE_READER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "file_reader.hpp"
+#include "pcap/packet/packet_batch.hpp"
+
+namespace pcap
+{
+class Packet;
+
+/**
+ * @brief Reads several captures as one: packets of all files are returned in global timestamp order
+ * by a k-way merge over a heap of the inputs' next packets, no merged copy is written.
+ * 
+ * Every input reads ahead on its own in the background and holds at most its read-ahead buffers and one batch arena,
+ * so memory does not depend on file sizes. Packets of equal timestamps come in the order of the file names.
+ */
+class MultiFileReader final
+{
+public:
+	struct Options
+	{
+		FileReader::Options reader{.mode = FileReader::Mode::readAhead, .readAhead = {.queueDepth = 2, .bufferSize = 1024 * 1024}};
+		// packets each input decodes at once
+		uint64_t batchPackets{1024};
+		uint64_t arenaSize{1024 * 1024};
+	};
+
+	explicit MultiFileReader(const std::vector<std::string>& fileNames);
+	MultiFileReader(const std::vector<std::string>& fileNames, const Options& options);
+	MultiFileReader(const MultiFileReader&) = delete;
+	MultiFileReader(MultiFileReader&&) noexcept = default;
+	MultiFileReader& operator=(const MultiFileReader&) = delete;
+	MultiFileReader& operator=(MultiFileReader&&) noexcept = default;
+
+	/**
+	 * @brief Reads the oldest packet of all files. The packet refers to the input's batch,
+	 * its data stays valid until the next read.
+	 * 
+	 * @param packet Packet
+	 * 
+	 * @return `True` if any file has packets left, otherwise - `false`
+	 */
+	[[nodiscard]] bool readNextPacket(Packet& packet);
+
+	/**
+	 * @brief Positions every file at its first packet not older than a point in time.
+	 * 
+	 * @param timestamp Timestamp `nanoseconds`
+	 * 
+	 * @return `True` if any file has such a packet, otherwise - `false`
+	 */
+	[[nodiscard]] bool seekTime(uint64_t timestamp);
+
+	/**
+	 * @brief Sets the filter applied by every file reader.
+	 * 
+	 * @param filter Compiled packet filter
+	 */
+	void setFilter(const Filter& filter);
+
+	/**
+	 * @brief Returns the number of packets returned so far.
+	 * 
+	 * @return Number of packets read
+	 */
+	[[nodiscard]] uint64_t readPackets() const noexcept;
+
+	/**
+	 * @brief Returns the number of files.
+	 * 
+	 * @return Number of files
+	 */
+	[[nodiscard]] uint64_t size() const noexcept;
+
+private:
+	struct Input
+	{
+		FileReader reader;
+		PacketBatch batch;
+		uint64_t position;
+	};
+
+	struct HeapEntry
+	{
+		uint64_t timestamp;
+		uint64_t input;
+	};
+
+	// refills the input's batch when it is consumed and puts the input back to the heap if it has packets left
+	void schedule(uint64_t input);
+
+	static bool later(const HeapEntry& first, const HeapEntry& second) noexcept;
+
+	std::vector<Input> inputs_;
+	std::vector<HeapEntry> heap_;
+	Options options_;
+	uint64_t readPackets_;
+	// the input of the previously returned packet: it advances on the next read, so the packet data stays valid until then
+	uint64_t current_;
+	bool started_;
+};
+} // namespace pcap
+
+#endif // PCAP_MULTI_FILE_READER_HPP
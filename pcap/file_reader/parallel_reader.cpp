@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parallel_reader.hpp"
+#include "pcap/packet/packet.hpp"
+#include "pcap/packet/packet_batch.hpp"
+
+namespace pcap
+{
+namespace
+{
+struct Chunk
+{
+	uint64_t index;
+	PacketBatch batch;
+};
+
+class ChunkQueue final
+{
+public:
+	explicit ChunkQueue(uint64_t capacity) : capacity_{capacity}, delivered_{}, stopped_{}, finished_{} {}
+
+	bool push(Chunk&& chunk)
+	{
+		std::unique_lock lock{mutex_};
+		pushed_.wait(lock, [this] { return chunks_.size() < capacity_ or stopped_; });
+
+		if (stopped_)
+		{
+			return false;
+		}
+
+		chunks_.push_back(std::move(chunk));
+		popped_.notify_one();
+
+		return true;
+	}
+
+	bool pop(Chunk& chunk)
+	{
+		std::unique_lock lock{mutex_};
+		popped_.wait(lock, [this] { return not chunks_.empty() or stopped_ or finished_; });
+
+		if (stopped_ or chunks_.empty())
+		{
+			return false;
+		}
+
+		chunk = std::move(chunks_.front());
+		chunks_.pop_front();
+		pushed_.notify_one();
+
+		return true;
+	}
+
+	bool waitTurn(uint64_t index)
+	{
+		std::unique_lock lock{mutex_};
+		turn_.wait(lock, [this, index] { return delivered_ == index or stopped_; });
+
+		return not stopped_;
+	}
+
+	void endTurn()
+	{
+		std::lock_guard lock{mutex_};
+		++delivered_;
+		turn_.notify_all();
+	}
+
+	void finish()
+	{
+		std::lock_guard lock{mutex_};
+		finished_ = true;
+		popped_.notify_all();
+	}
+
+	void stop(std::exception_ptr exception)
+	{
+		std::lock_guard lock{mutex_};
+
+		if (not exception_)
+		{
+			exception_ = exception;
+		}
+
+		stopped_ = true;
+		pushed_.notify_all();
+		popped_.notify_all();
+		turn_.notify_all();
+	}
+
+	std::exception_ptr exception()
+	{
+		std::lock_guard lock{mutex_};
+		return exception_;
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable pushed_;
+	std::condition_variable popped_;
+	std::condition_variable turn_;
+	std::deque<Chunk> chunks_;
+	std::exception_ptr exception_;
+	uint64_t capacity_;
+	uint64_t delivered_;
+	bool stopped_;
+	bool finished_;
+};
+
+void work(ChunkQueue& queue, const ParallelReader::Callback& callback, ParallelReader::Delivery delivery)
+{
+	Chunk chunk{0, PacketBatch{0}};
+	std::vector<Packet> packets;
+	std::vector<uint8_t> parsed;
+
+	while (queue.pop(chunk))
+	{
+		try
+		{
+			const auto& batch{chunk.batch};
+
+			if (delivery == ParallelReader::Delivery::unordered)
+			{
+				Packet packet;
+
+				for (uint64_t i{}; i < batch.size(); ++i)
+				{
+					batch.packet(i, packet);
+					callback(packet, packet.parse());
+				}
+
+				continue;
+			}
+
+			// packets keep their layer storage between chunks, so the steady state does not allocate
+			packets.resize(std::max<uint64_t>(packets.size(), batch.size()));
+			parsed.resize(packets.size());
+
+			for (uint64_t i{}; i < batch.size(); ++i)
+			{
+				batch.packet(i, packets[i]);
+				parsed[i] = packets[i].parse();
+			}
+
+			if (not queue.waitTurn(chunk.index))
+			{
+				return;
+			}
+
+			for (uint64_t i{}; i < batch.size(); ++i)
+			{
+				callback(packets[i], parsed[i]);
+			}
+
+			queue.endTurn();
+		}
+		catch (...)
+		{
+			queue.stop(std::current_exception());
+			return;
+		}
+	}
+}
+} // namespace
+
+ParallelReader::ParallelReader(const std::string& fileName) : ParallelReader(fileName, Options{}) {}
+
+ParallelReader::ParallelReader(const std::string& fileName, const Options& options)
+	: reader_{fileName, FileReader::Options{.mode = FileReader::Mode::memoryMapped}}
+	, options_{options}
+{
+	if (options_.threads == 0)
+	{
+		options_.threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	options_.chunkPackets = std::max<uint64_t>(1, options_.chunkPackets);
+}
+
+uint64_t ParallelReader::run(const Callback& callback)
+{
+	ChunkQueue queue{2ull * options_.threads};
+
+	uint64_t packets{};
+
+	{
+		std::vector<std::jthread> workers;
+		workers.reserve(options_.threads);
+
+		for (uint32_t i{}; i < options_.threads; ++i)
+		{
+			workers.emplace_back(work, std::ref(queue), std::cref(callback), options_.delivery);
+		}
+
+		try
+		{
+			for (uint64_t index{};; ++index)
+			{
+				// the batch only holds packet boundaries: its data refers to the memory-mapped file
+				PacketBatch batch{0};
+
+				if (not reader_.readBatch(batch, options_.chunkPackets))
+				{
+					break;
+				}
+
+				packets += batch.size();
+
+				if (not queue.push(Chunk{index, std::move(batch)}))
+				{
+					break;
+				}
+			}
+
+			queue.finish();
+		}
+		catch (...)
+		{
+			queue.stop(std::current_exception());
+		}
+	}
+
+	if (auto exception{queue.exception()})
+	{
+		std::rethrow_exception(exception);
+	}
+
+	return packets;
+}
+
+uint64_t ParallelReader::fileSize() const noexcept
+{
+	return reader_.fileSize();
+}
+} // namespace pcap
@@ -0,0 +1,69 @@
+#ifndef PCAP_PARALLEL_READER_HPP
+#define PCAP_PARALLEL_READER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "file_reader.hpp"
+
+namespace pcap
+{
+class Packet;
+
+class ParallelReader final
+{
+public:
+	enum class Delivery : uint8_t
+	{
+		// callbacks are invoked one at a time in file order, parsing still runs in parallel
+		ordered,
+		// callbacks are invoked concurrently from worker threads as soon as a chunk is parsed
+		unordered
+	};
+
+	struct Options
+	{
+		uint32_t threads{0};
+		uint64_t chunkPackets{4096};
+		Delivery delivery{Delivery::ordered};
+	};
+
+	/**
+	 * @brief Callback receiving a packet and the result of its `Packet::parse()`.
+	 */
+	using Callback = std::function<void(const Packet&, bool)>;
+
+	explicit ParallelReader(const std::string& fileName);
+	ParallelReader(const std::string& fileName, const Options& options);
+	ParallelReader(const ParallelReader&) = delete;
+	ParallelReader(ParallelReader&&) noexcept = default;
+	ParallelReader& operator=(const ParallelReader&) = delete;
+	ParallelReader& operator=(ParallelReader&&) noexcept = default;
+
+	/**
+	 * @brief Reads the whole file: the calling thread scans packet boundaries and splits the file into chunks,
+	 * worker threads parse the chunks and invoke the callback.
+	 * 
+	 * An exception thrown by the callback stops reading and is rethrown to the caller.
+	 * 
+	 * @param callback Packet callback
+	 * 
+	 * @return Number of packets read
+	 */
+	uint64_t run(const Callback& callback);
+
+	/**
+	 * @brief Returns the file size.
+	 * 
+	 * @return File size
+	 */
+	[[nodiscard]] uint64_t fileSize() const noexcept;
+
+private:
+	FileReader reader_;
+	Options options_;
+};
+} // namespace pcap
+
+#endif // PCAP_PARALLEL_READER_HPP
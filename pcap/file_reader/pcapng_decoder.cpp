@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <cstring>
+
+#include "pcapng_decoder.hpp"
+#include "pcap/utils/byte_swapper.hpp"
+
+constexpr uint8_t magicNumberSectionHeader[]{0x0a, 0x0d, 0x0d, 0x0a};
+constexpr uint32_t byteOrderMagic{0x1a2b3c4d};
+constexpr uint16_t optionEnd{0};
+constexpr uint16_t optionTimestampResolution{9};
+constexpr uint16_t optionTimestampOffset{14};
+
+namespace pcap
+{
+PcapngDecoder::PcapngDecoder() noexcept : interfaces_{}, endian_{std::endian::native}, processedOffset_{} {}
+
+bool PcapngDecoder::isSectionHeader(std::span<const uint8_t> data) noexcept
+{
+	return data.size() >= std::size(magicNumberSectionHeader) and
+	       !std::memcmp(data.data(), magicNumberSectionHeader, std::size(magicNumberSectionHeader));
+}
+
+uint32_t PcapngDecoder::packetPrefixSize(uint32_t type) noexcept
+{
+	switch (type)
+	{
+	case enhancedPacket:
+		return sizeof(EnhancedPacketBlock);
+	case simplePacket:
+		return sizeof(SimplePacketBlock);
+	default:
+		return 0;
+	}
+}
+
+PcapngDecoder::BlockHeader PcapngDecoder::blockHeader(std::span<const uint8_t> data) const noexcept
+{
+	BlockHeader header{};
+
+	if (data.size() < minimumBlockSize)
+	{
+		return header;
+	}
+
+	std::memcpy(&header, data.data(), sizeof(BlockHeader));
+
+	auto endian{endian_};
+
+	if (header.type == sectionHeader)
+	{
+		// the section header is palindromic, its byte-order magic tells how the rest of the section is stored
+		uint32_t magic{};
+		std::memcpy(&magic, data.data() + sizeof(BlockHeader), sizeof(magic));
+
+		if (magic == byteOrderMagic)
+		{
+			endian = std::endian::native;
+		}
+		else if (bswap32(magic) == byteOrderMagic)
+		{
+			endian = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+		}
+		else
+		{
+			return {header.type, 0};
+		}
+	}
+
+	ByteSwapper{}(header, endian);
+
+	if (header.length < minimumBlockSize or header.length % 4 != 0)
+	{
+		header.length = 0;
+	}
+
+	return header;
+}
+
+bool PcapngDecoder::metadata(std::span<const uint8_t> block, uint64_t offset)
+{
+	const auto header{blockHeader(block)};
+
+	if (header.length != block.size())
+	{
+		return false;
+	}
+
+	if (offset < processedOffset_ or (header.type != sectionHeader and header.type != interfaceDescription))
+	{
+		return true;
+	}
+
+	processedOffset_ = offset + block.size();
+
+	if (header.type == sectionHeader)
+	{
+		SectionHeaderBlock section{};
+
+		if (block.size() < sizeof(SectionHeaderBlock) + sizeof(uint32_t))
+		{
+			return false;
+		}
+
+		std::memcpy(&section, block.data(), sizeof(SectionHeaderBlock));
+		endian_ = section.byteOrderMagic == byteOrderMagic ? std::endian::native :
+								     (std::endian::native == std::endian::little ? std::endian::big : std::endian::little);
+		ByteSwapper{}(section, endian_);
+
+		// interface ids are local to a section
+		interfaces_.clear();
+
+		return section.versionMajor == 1;
+	}
+
+	InterfaceDescriptionBlock description{};
+
+	if (block.size() < sizeof(InterfaceDescriptionBlock) + sizeof(uint32_t))
+	{
+		return false;
+	}
+
+	std::memcpy(&description, block.data(), sizeof(InterfaceDescriptionBlock));
+	ByteSwapper{}(description, endian_);
+
+	// microseconds unless `if_tsresol` says otherwise
+	Interface interface{description.linkLayerType, description.snapLength, 1000, 1, 0};
+
+	auto options{block.subspan(sizeof(InterfaceDescriptionBlock), block.size() - sizeof(InterfaceDescriptionBlock) - sizeof(uint32_t))};
+
+	while (options.size() >= 2 * sizeof(uint16_t))
+	{
+		uint16_t option[2]{};
+		std::memcpy(option, options.data(), sizeof(option));
+
+		if (endian_ != std::endian::native)
+		{
+			option[0] = bswap16(option[0]);
+			option[1] = bswap16(option[1]);
+		}
+
+		const auto [code, length]{option};
+		const auto paddedLength{(static_cast<uint64_t>(length) + 3) / 4 * 4};
+
+		if (code == optionEnd)
+		{
+			break;
+		}
+
+		if (options.size() - sizeof(option) < paddedLength)
+		{
+			return false;
+		}
+
+		const auto value{options.subspan(sizeof(option), length)};
+
+		if (code == optionTimestampResolution and length == 1)
+		{
+			const auto exponent{value[0] & 0x7f};
+
+			if (value[0] & 0x80)
+			{
+				// negative power of two
+				if (exponent > 63)
+				{
+					return false;
+				}
+
+				interface.multiplier = 1'000'000'000;
+				interface.divisor = uint64_t{1} << exponent;
+			}
+			else
+			{
+				// negative power of ten
+				if (exponent > 19)
+				{
+					return false;
+				}
+
+				interface.multiplier = 1;
+				interface.divisor = 1;
+
+				for (auto i{exponent}; i < 9; ++i)
+				{
+					interface.multiplier *= 10;
+				}
+
+				for (auto i{9}; i < exponent; ++i)
+				{
+					interface.divisor *= 10;
+				}
+			}
+		}
+		else if (code == optionTimestampOffset and length == sizeof(int64_t))
+		{
+			std::memcpy(&interface.offset, value.data(), sizeof(int64_t));
+
+			if (endian_ != std::endian::native)
+			{
+				interface.offset = static_cast<int64_t>(bswap64(static_cast<uint64_t>(interface.offset)));
+			}
+		}
+
+		options = options.subspan(sizeof(option) + paddedLength);
+	}
+
+	interfaces_.push_back(interface);
+
+	return true;
+}
+
+bool PcapngDecoder::packet(const BlockHeader& header, std::span<const uint8_t> prefix, Record& record) const noexcept
+{
+	if (header.type == enhancedPacket)
+	{
+		EnhancedPacketBlock block{};
+
+		if (prefix.size() < sizeof(EnhancedPacketBlock) or header.length < sizeof(EnhancedPacketBlock) + sizeof(uint32_t))
+		{
+			return false;
+		}
+
+		std::memcpy(&block, prefix.data(), sizeof(EnhancedPacketBlock));
+		ByteSwapper{}(block, endian_);
+
+		if (block.interfaceId >= interfaces_.size() or
+		    header.length - sizeof(EnhancedPacketBlock) - sizeof(uint32_t) < block.capturedLength)
+		{
+			return false;
+		}
+
+		const auto& interface{interfaces_[block.interfaceId]};
+
+		record.timestamp = timestamp(interface, (static_cast<uint64_t>(block.timestampHigh) << 32) | block.timestampLow);
+		record.linkLayerType = interface.linkLayerType;
+		record.currentLength = block.capturedLength;
+		record.originalLength = block.originalLength;
+		record.trailerLength = header.length - sizeof(EnhancedPacketBlock) - block.capturedLength;
+
+		return true;
+	}
+
+	if (header.type == simplePacket)
+	{
+		SimplePacketBlock block{};
+
+		if (prefix.size() < sizeof(SimplePacketBlock) or header.length < sizeof(SimplePacketBlock) + sizeof(uint32_t) or interfaces_.empty())
+		{
+			return false;
+		}
+
+		std::memcpy(&block, prefix.data(), sizeof(SimplePacketBlock));
+		ByteSwapper{}(block, endian_);
+
+		const auto& interface{interfaces_.front()};
+
+		// simple packets carry neither a captured length nor a timestamp
+		auto capturedLength{std::min<uint32_t>(block.originalLength, header.length - sizeof(SimplePacketBlock) - sizeof(uint32_t))};
+
+		if (interface.snapLength != 0)
+		{
+			capturedLength = std::min(capturedLength, interface.snapLength);
+		}
+
+		record.timestamp = {};
+		record.linkLayerType = interface.linkLayerType;
+		record.currentLength = capturedLength;
+		record.originalLength = block.originalLength;
+		record.trailerLength = header.length - sizeof(SimplePacketBlock) - capturedLength;
+
+		return true;
+	}
+
+	return false;
+}
+
+std::endian PcapngDecoder::endian() const noexcept
+{
+	return endian_;
+}
+
+std::chrono::nanoseconds PcapngDecoder::timestamp(const Interface& interface, uint64_t units) const noexcept
+{
+#ifdef __SIZEOF_INT128__
+	__extension__ using Wide = unsigned __int128;
+	const auto nanoseconds{static_cast<Wide>(units) * interface.multiplier / interface.divisor};
+#else
+	// either the multiplier or the divisor is 1 for powers of ten, the remainder product only overflows
+	// for powers of two finer than 2^-34 seconds
+	const auto nanoseconds{units / interface.divisor * interface.multiplier + units % interface.divisor * interface.multiplier / interface.divisor};
+#endif
+
+	return std::chrono::nanoseconds{static_cast<int64_t>(nanoseconds)} + std::chrono::seconds{interface.offset};
+}
+} // namespace pcap
@@ -0,0 +1,163 @@
+#ifndef PCAP_PCAPNG_DECODER_HPP
+#define PCAP_PCAPNG_DECODER_HPP
+
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pcap
+{
+/**
+ * @brief Decoder of pcapng blocks: keeps the section byte order and the interface table,
+ * turns packet blocks into packet records.
+ */
+class PcapngDecoder final
+{
+public:
+	enum BlockType : uint32_t
+	{
+		sectionHeader = 0x0a0d0d0a,
+		interfaceDescription = 0x00000001,
+		simplePacket = 0x00000003,
+		enhancedPacket = 0x00000006
+	};
+
+#pragma pack(push, 1)
+	struct BlockHeader
+	{
+		uint32_t type;
+		uint32_t length;
+	};
+
+	struct SectionHeaderBlock
+	{
+		uint32_t type;
+		uint32_t length;
+		uint32_t byteOrderMagic;
+		uint16_t versionMajor;
+		uint16_t versionMinor;
+		uint64_t sectionLength;
+	};
+
+	struct InterfaceDescriptionBlock
+	{
+		uint32_t type;
+		uint32_t length;
+		uint16_t linkLayerType;
+		uint16_t reserved;
+		uint32_t snapLength;
+	};
+
+	struct EnhancedPacketBlock
+	{
+		uint32_t type;
+		uint32_t length;
+		uint32_t interfaceId;
+		uint32_t timestampHigh;
+		uint32_t timestampLow;
+		uint32_t capturedLength;
+		uint32_t originalLength;
+	};
+
+	struct SimplePacketBlock
+	{
+		uint32_t type;
+		uint32_t length;
+		uint32_t originalLength;
+	};
+#pragma pack(pop)
+
+	struct Record
+	{
+		std::chrono::nanoseconds timestamp;
+		uint32_t linkLayerType;
+		uint32_t currentLength;
+		uint32_t originalLength;
+		// bytes between the end of the packet data and the end of the block
+		uint32_t trailerLength;
+	};
+
+	// every block carries at least its type and two length fields, a section header also its byte-order magic
+	static constexpr uint32_t minimumBlockSize{12};
+
+	PcapngDecoder() noexcept;
+
+	/**
+	 * @brief Checks whether the data starts with a pcapng section header.
+	 * 
+	 * @param data Beginning of the file
+	 * 
+	 * @return `True` if this is a pcapng file, otherwise - `false`
+	 */
+	[[nodiscard]] static bool isSectionHeader(std::span<const uint8_t> data) noexcept;
+
+	/**
+	 * @brief Returns the size of a packet block prefix which precedes the packet data.
+	 * 
+	 * @param type Block type
+	 * 
+	 * @return Prefix size, `0` if the block does not hold a packet
+	 */
+	[[nodiscard]] static uint32_t packetPrefixSize(uint32_t type) noexcept;
+
+	/**
+	 * @brief Decodes a block header in the section byte order, for a section header - in its own byte order.
+	 * 
+	 * @param data At least `minimumBlockSize` bytes of the block
+	 * 
+	 * @return Block header, a zero length if the header is invalid
+	 */
+	[[nodiscard]] BlockHeader blockHeader(std::span<const uint8_t> data) const noexcept;
+
+	/**
+	 * @brief Processes a metadata block: section headers reset the interface table, interface descriptions extend it,
+	 * other blocks are ignored. Blocks at offsets that were already processed are ignored too, so the file may be reread.
+	 * 
+	 * @param block Whole block
+	 * @param offset Block file offset
+	 * 
+	 * @return `True` if the block is valid, otherwise - `false`
+	 */
+	[[nodiscard]] bool metadata(std::span<const uint8_t> block, uint64_t offset);
+
+	/**
+	 * @brief Decodes a packet block prefix.
+	 * 
+	 * @param header Block header
+	 * @param prefix `packetPrefixSize()` first bytes of the block
+	 * @param record Packet record
+	 * 
+	 * @return `True` if the block is valid, otherwise - `false`
+	 */
+	[[nodiscard]] bool packet(const BlockHeader& header, std::span<const uint8_t> prefix, Record& record) const noexcept;
+
+	/**
+	 * @brief Returns the section byte order.
+	 * 
+	 * @return Section byte order
+	 */
+	[[nodiscard]] std::endian endian() const noexcept;
+
+private:
+	struct Interface
+	{
+		uint32_t linkLayerType;
+		uint32_t snapLength;
+		// timestamp units are converted as `units * multiplier / divisor` nanoseconds
+		uint64_t multiplier;
+		uint64_t divisor;
+		int64_t offset;
+	};
+
+	std::chrono::nanoseconds timestamp(const Interface& interface, uint64_t units) const noexcept;
+
+	std::vector<Interface> interfaces_;
+	std::endian endian_;
+	// end of the last processed metadata block
+	uint64_t processedOffset_;
+};
+} // namespace pcap
+
+#endif // PCAP_PCAPNG_DECODER_HPP
@@ -0,0 +1,664 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "arrow_writer.hpp"
+#include "pcap/packet/packet.hpp"
+#include "pcap/packet/packet_batch.hpp"
+#include "pcap/utils/batch_decoder.hpp"
+
+// encapsulated message: continuation marker, metadata size, FlatBuffers metadata padded to 8 bytes, body
+constexpr uint32_t continuationMarker{0xffffffff};
+constexpr uint64_t messagePrefixSize{8};
+// body buffers are aligned as recommended by the format, so that readers can map them as they are
+constexpr uint64_t bufferAlignment{64};
+// MetadataVersion.V5
+constexpr uint64_t metadataVersion{4};
+// MessageHeader union
+constexpr uint64_t headerSchema{1};
+constexpr uint64_t headerDictionaryBatch{2};
+constexpr uint64_t headerRecordBatch{3};
+// Type union
+constexpr uint8_t typeInt{2};
+constexpr uint8_t typeTimestamp{10};
+constexpr uint64_t timeUnitNanosecond{3};
+constexpr int64_t sourceDictionaryId{0};
+constexpr int64_t destinationDictionaryId{1};
+
+namespace pcap
+{
+namespace
+{
+// minimal FlatBuffers encoder: objects are laid out front to back, each one after the offsets referring to it,
+// so that offsets only point forward as the format requires
+class FlatBuffer final
+{
+public:
+	static constexpr uint64_t maxFields{8};
+
+	struct Field
+	{
+		uint16_t id;
+		// scalar width in bytes, zero for an offset to an object encoded later
+		uint8_t size;
+		uint64_t value;
+	};
+
+	struct Table
+	{
+		uint64_t position;
+		std::array<uint64_t, maxFields> fields;
+	};
+
+	explicit FlatBuffer(std::vector<uint8_t>& data) noexcept : data_{data} {}
+
+	// pads the data until `extra` bytes later are aligned
+	void align(uint64_t alignment, uint64_t extra = 0)
+	{
+		data_.resize((data_.size() + extra + alignment - 1) / alignment * alignment - extra);
+	}
+
+	template <typename T>
+	uint64_t put(T value)
+	{
+		align(sizeof(T));
+
+		const auto position{data_.size()};
+
+		data_.resize(position + sizeof(T));
+		store(position, value);
+
+		return position;
+	}
+
+	template <typename T>
+	void store(uint64_t position, T value) noexcept
+	{
+		if constexpr (std::endian::native == std::endian::big and sizeof(T) > 1)
+		{
+			value = std::byteswap(value);
+		}
+
+		std::memcpy(data_.data() + position, &value, sizeof(T));
+	}
+
+	// offset to an object encoded later, see `patch()`
+	uint64_t reference()
+	{
+		return put<uint32_t>(0);
+	}
+
+	void patch(uint64_t reference, uint64_t target) noexcept
+	{
+		store(reference, static_cast<uint32_t>(target - reference));
+	}
+
+	// table preceded by its vtable, fields are placed by decreasing width to avoid padding
+	Table table(std::initializer_list<Field> fields)
+	{
+		const auto width{[](const Field& field) { return field.size == 0 ? uint8_t{4} : field.size; }};
+
+		uint16_t count{};
+		uint8_t alignment{4};
+
+		for (const auto& field : fields)
+		{
+			count = std::max<uint16_t>(count, field.id + 1);
+			alignment = std::max(alignment, width(field));
+		}
+
+		const auto vtable{put<uint16_t>(static_cast<uint16_t>(4 + 2 * count))};
+		put<uint16_t>(0);
+
+		for (uint16_t i{}; i < count; ++i)
+		{
+			put<uint16_t>(0);
+		}
+
+		align(alignment);
+
+		Table table{data_.size(), {}};
+		put<int32_t>(static_cast<int32_t>(table.position - vtable));
+
+		std::vector<Field> sorted{fields};
+		std::ranges::stable_sort(sorted, std::ranges::greater{}, width);
+
+		for (const auto& field : sorted)
+		{
+			uint64_t position{};
+
+			switch (width(field))
+			{
+			case 1:
+				position = put(static_cast<uint8_t>(field.value));
+				break;
+			case 2:
+				position = put(static_cast<uint16_t>(field.value));
+				break;
+			case 4:
+				position = put(static_cast<uint32_t>(field.value));
+				break;
+			default:
+				position = put(field.value);
+				break;
+			}
+
+			store(vtable + 4 + 2 * field.id, static_cast<uint16_t>(position - table.position));
+			table.fields[field.id] = position;
+		}
+
+		store(vtable + 2, static_cast<uint16_t>(data_.size() - table.position));
+
+		return table;
+	}
+
+	// vector of zeroed elements, returns the position of its length, elements follow it
+	uint64_t vector(uint64_t count, uint64_t elementSize, uint64_t elementAlignment)
+	{
+		align(std::max<uint64_t>(elementAlignment, 4), 4);
+
+		const auto position{put(static_cast<uint32_t>(count))};
+		data_.resize(data_.size() + count * elementSize);
+
+		return position;
+	}
+
+	uint64_t string(std::string_view value)
+	{
+		const auto position{put(static_cast<uint32_t>(value.size()))};
+
+		data_.insert(data_.end(), value.begin(), value.end());
+		data_.push_back(0);
+
+		return position;
+	}
+
+private:
+	std::vector<uint8_t>& data_;
+};
+
+struct Column
+{
+	std::string_view name;
+	uint8_t type;
+	uint8_t bitWidth;
+	bool nullable;
+	// dictionary id of dictionary-encoded columns, otherwise -1
+	int64_t dictionaryId;
+};
+
+constexpr Column columns[]{{"timestamp", typeTimestamp, 64, false, -1},
+			   {"captured_length", typeInt, 32, false, -1},
+			   {"original_length", typeInt, 32, false, -1},
+			   {"link_layer_type", typeInt, 32, false, -1},
+			   {"source_address", typeInt, 32, true, sourceDictionaryId},
+			   {"destination_address", typeInt, 32, true, destinationDictionaryId},
+			   {"source_port", typeInt, 16, true, -1},
+			   {"destination_port", typeInt, 16, true, -1},
+			   {"protocol", typeInt, 8, true, -1}};
+
+// FieldNode struct
+struct Node
+{
+	uint64_t length;
+	uint64_t nullCount;
+};
+
+struct Buffer
+{
+	const void* data;
+	uint64_t size;
+};
+
+// writes the message prefix once the metadata is complete
+void finishMetadata(std::vector<uint8_t>& message)
+{
+	message.resize((message.size() + 7) / 8 * 8);
+
+	const auto metadataSize{static_cast<uint32_t>(message.size() - messagePrefixSize)};
+
+	std::memcpy(message.data(), &continuationMarker, sizeof(continuationMarker));
+	std::memcpy(message.data() + sizeof(continuationMarker), &metadataSize, sizeof(metadataSize));
+}
+
+void encodeSchema(std::vector<uint8_t>& message)
+{
+	message.assign(messagePrefixSize, 0);
+
+	FlatBuffer buffer{message};
+
+	const auto root{buffer.reference()};
+	const auto header{buffer.table({{0, 2, metadataVersion}, {1, 1, headerSchema}, {2, 0, 0}, {3, 8, 0}})};
+	buffer.patch(root, header.position);
+
+	const auto schema{buffer.table({{0, 2, std::endian::native == std::endian::little ? 0U : 1U}, {1, 0, 0}})};
+	buffer.patch(header.fields[2], schema.position);
+
+	const auto fields{buffer.vector(std::size(columns), sizeof(uint32_t), sizeof(uint32_t))};
+	buffer.patch(schema.fields[1], fields);
+
+	for (uint64_t i{}; i < std::size(columns); ++i)
+	{
+		const auto& column{columns[i]};
+		const auto dictionary{column.dictionaryId != -1};
+
+		auto field{dictionary ? buffer.table({{0, 0, 0}, {1, 1, column.nullable}, {2, 1, column.type}, {3, 0, 0}, {4, 0, 0}, {5, 0, 0}})
+				      : buffer.table({{0, 0, 0}, {1, 1, column.nullable}, {2, 1, column.type}, {3, 0, 0}, {5, 0, 0}})};
+		buffer.patch(fields + sizeof(uint32_t) * (i + 1), field.position);
+
+		buffer.patch(field.fields[0], buffer.string(column.name));
+
+		const auto type{column.type == typeTimestamp ? buffer.table({{0, 2, timeUnitNanosecond}})
+							     : buffer.table({{0, 4, column.bitWidth}, {1, 1, false}})};
+		buffer.patch(field.fields[3], type.position);
+
+		if (dictionary)
+		{
+			// signed 32-bit indices, the recommended index type
+			const auto encoding{buffer.table({{0, 8, static_cast<uint64_t>(column.dictionaryId)}, {1, 0, 0}})};
+			buffer.patch(field.fields[4], encoding.position);
+			buffer.patch(encoding.fields[1], buffer.table({{0, 4, 32}, {1, 1, true}}).position);
+		}
+
+		buffer.patch(field.fields[5], buffer.vector(0, sizeof(uint32_t), sizeof(uint32_t)));
+	}
+
+	finishMetadata(message);
+}
+
+// encodes a record batch, or a dictionary batch if `dictionaryId` is not -1, buffers sharing data are written once
+void encodeBatch(std::vector<uint8_t>& message,
+		 uint64_t length,
+		 std::span<const Node> nodes,
+		 std::span<const Buffer> buffers,
+		 int64_t dictionaryId = -1,
+		 bool delta = false)
+{
+	std::vector<uint64_t> offsets(buffers.size());
+	uint64_t bodyLength{};
+
+	for (uint64_t i{}; i < buffers.size(); ++i)
+	{
+		const auto shared{std::ranges::find_if(buffers.begin(),
+						       buffers.begin() + i,
+						       [&](const Buffer& buffer) { return buffer.data == buffers[i].data and buffer.size == buffers[i].size; })};
+
+		if (buffers[i].size == 0)
+		{
+			continue;
+		}
+
+		if (shared != buffers.begin() + i)
+		{
+			offsets[i] = offsets[shared - buffers.begin()];
+			continue;
+		}
+
+		offsets[i] = bodyLength;
+		bodyLength += (buffers[i].size + bufferAlignment - 1) / bufferAlignment * bufferAlignment;
+	}
+
+	message.assign(messagePrefixSize, 0);
+
+	FlatBuffer buffer{message};
+
+	const auto root{buffer.reference()};
+	const auto header{buffer.table({{0, 2, metadataVersion},
+					{1, 1, dictionaryId == -1 ? headerRecordBatch : headerDictionaryBatch},
+					{2, 0, 0},
+					{3, 8, bodyLength}})};
+	buffer.patch(root, header.position);
+
+	auto batchReference{header.fields[2]};
+
+	if (dictionaryId != -1)
+	{
+		const auto dictionary{buffer.table({{0, 8, static_cast<uint64_t>(dictionaryId)}, {1, 0, 0}, {2, 1, delta}})};
+		buffer.patch(batchReference, dictionary.position);
+		batchReference = dictionary.fields[1];
+	}
+
+	const auto batch{buffer.table({{0, 8, length}, {1, 0, 0}, {2, 0, 0}})};
+	buffer.patch(batchReference, batch.position);
+
+	const auto nodeVector{buffer.vector(nodes.size(), sizeof(Node), alignof(uint64_t))};
+	buffer.patch(batch.fields[1], nodeVector);
+
+	for (uint64_t i{}; i < nodes.size(); ++i)
+	{
+		buffer.store(nodeVector + sizeof(uint32_t) + sizeof(Node) * i, nodes[i].length);
+		buffer.store(nodeVector + sizeof(uint32_t) + sizeof(Node) * i + sizeof(uint64_t), nodes[i].nullCount);
+	}
+
+	const auto bufferVector{buffer.vector(buffers.size(), 2 * sizeof(uint64_t), alignof(uint64_t))};
+	buffer.patch(batch.fields[2], bufferVector);
+
+	for (uint64_t i{}; i < buffers.size(); ++i)
+	{
+		buffer.store(bufferVector + sizeof(uint32_t) + 2 * sizeof(uint64_t) * i, offsets[i]);
+		buffer.store(bufferVector + sizeof(uint32_t) + 2 * sizeof(uint64_t) * i + sizeof(uint64_t), buffers[i].size);
+	}
+
+	finishMetadata(message);
+
+	const auto body{message.size()};
+	message.resize(body + bodyLength);
+
+	for (uint64_t i{}; i < buffers.size(); ++i)
+	{
+		if (buffers[i].size != 0)
+		{
+			std::memcpy(message.data() + body + offsets[i], buffers[i].data, buffers[i].size);
+		}
+	}
+}
+} // namespace
+
+ArrowWriter::ArrowWriter(const std::string& fileName) : ArrowWriter(fileName, Options{}) {}
+
+ArrowWriter::ArrowWriter(const std::string& fileName, const Options& options)
+	: fileName_{fileName}
+	, options_{options}
+	, timestamps_{}
+	, lengths_{}
+	, originalLengths_{}
+	, linkLayerTypes_{}
+	, sourceAddresses_{}
+	, destinationAddresses_{}
+	, sourcePorts_{}
+	, destinationPorts_{}
+	, protocols_{}
+	, validity_{}
+	, tuples_{}
+	, sourceDictionary_{}
+	, destinationDictionary_{}
+	, message_{}
+	, nullCount_{}
+	, writtenRows_{}
+	, writtenBytes_{}
+	, descriptor_{-1}
+	, dictionariesWritten_{false}
+{
+	options_.batchRows = std::max<uint64_t>(options_.batchRows, 1);
+
+	descriptor_ = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if (descriptor_ == -1)
+	{
+		throw std::runtime_error(std::format("pcap::ArrowWriter [exception]: cannot open '{}': {}.", fileName, std::strerror(errno)));
+	}
+
+	timestamps_.reserve(options_.batchRows);
+	lengths_.reserve(options_.batchRows);
+	originalLengths_.reserve(options_.batchRows);
+	linkLayerTypes_.reserve(options_.batchRows);
+	sourceAddresses_.reserve(options_.batchRows);
+	destinationAddresses_.reserve(options_.batchRows);
+	sourcePorts_.reserve(options_.batchRows);
+	destinationPorts_.reserve(options_.batchRows);
+	protocols_.reserve(options_.batchRows);
+	validity_.reserve((options_.batchRows + 7) / 8);
+
+	try
+	{
+		writeSchema();
+	}
+	catch (...)
+	{
+		::close(descriptor_);
+		throw;
+	}
+}
+
+ArrowWriter::~ArrowWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+	}
+}
+
+void ArrowWriter::write(const Packet& packet)
+{
+	const auto length{static_cast<uint32_t>(packet.data().size())};
+
+	append(packet.timestamp(), length, length, packet.linkLayerType(), extractFiveTuple(packet.data(), packet.linkLayerType()));
+}
+
+void ArrowWriter::write(const PacketBatch& batch)
+{
+	batch.fiveTuples(tuples_);
+
+	const auto timestamps{batch.timestamps()};
+	const auto lengths{batch.lengths()};
+	const auto originalLengths{batch.originalLengths()};
+	const auto linkLayerTypes{batch.linkLayerTypes()};
+
+	for (uint64_t i{}; i < batch.size(); ++i)
+	{
+		append(timestamps[i], lengths[i], originalLengths[i], linkLayerTypes[i], tuples_[i]);
+	}
+}
+
+void ArrowWriter::flush()
+{
+	if (timestamps_.empty())
+	{
+		return;
+	}
+
+	writeDictionary(sourceDictionaryId, sourceDictionary_);
+	writeDictionary(destinationDictionaryId, destinationDictionary_);
+	dictionariesWritten_ = true;
+
+	writeRecordBatch();
+
+	timestamps_.clear();
+	lengths_.clear();
+	originalLengths_.clear();
+	linkLayerTypes_.clear();
+	sourceAddresses_.clear();
+	destinationAddresses_.clear();
+	sourcePorts_.clear();
+	destinationPorts_.clear();
+	protocols_.clear();
+	validity_.clear();
+	nullCount_ = 0;
+
+	// the next batch starts a replacement dictionary
+	for (auto* dictionary : {&sourceDictionary_, &destinationDictionary_})
+	{
+		if (dictionary->values.size() >= options_.maxDictionarySize)
+		{
+			dictionary->indices.clear();
+			dictionary->values.clear();
+			dictionary->written = 0;
+		}
+	}
+}
+
+void ArrowWriter::close()
+{
+	if (descriptor_ == -1)
+	{
+		return;
+	}
+
+	try
+	{
+		flush();
+
+		// end-of-stream marker
+		message_.assign(messagePrefixSize, 0);
+		std::memcpy(message_.data(), &continuationMarker, sizeof(continuationMarker));
+		writeOut(message_);
+	}
+	catch (...)
+	{
+		::close(std::exchange(descriptor_, -1));
+		throw;
+	}
+
+	if (::close(std::exchange(descriptor_, -1)) == -1)
+	{
+		throw std::runtime_error(std::format("pcap::ArrowWriter [exception]: cannot close '{}': {}.", fileName_, std::strerror(errno)));
+	}
+}
+
+uint64_t ArrowWriter::writtenRows() const noexcept
+{
+	return writtenRows_;
+}
+
+uint64_t ArrowWriter::writtenBytes() const noexcept
+{
+	return writtenBytes_;
+}
+
+void ArrowWriter::append(uint64_t timestamp, uint32_t length, uint32_t originalLength, uint32_t linkLayerType, const FiveTuple& tuple)
+{
+	const auto row{timestamps_.size()};
+
+	timestamps_.push_back(static_cast<int64_t>(timestamp));
+	lengths_.push_back(length);
+	originalLengths_.push_back(originalLength);
+	linkLayerTypes_.push_back(linkLayerType);
+
+	if (row % 8 == 0)
+	{
+		validity_.push_back(0);
+	}
+
+	if (tuple.valid)
+	{
+		validity_.back() |= static_cast<uint8_t>(1 << (row % 8));
+		sourceAddresses_.push_back(encode(sourceDictionary_, tuple.sourceAddress));
+		destinationAddresses_.push_back(encode(destinationDictionary_, tuple.destinationAddress));
+		sourcePorts_.push_back(tuple.sourcePort);
+		destinationPorts_.push_back(tuple.destinationPort);
+		protocols_.push_back(tuple.protocol);
+	}
+	else
+	{
+		sourceAddresses_.push_back(0);
+		destinationAddresses_.push_back(0);
+		sourcePorts_.push_back(0);
+		destinationPorts_.push_back(0);
+		protocols_.push_back(0);
+		++nullCount_;
+	}
+
+	++writtenRows_;
+
+	if (timestamps_.size() == options_.batchRows)
+	{
+		flush();
+	}
+}
+
+void ArrowWriter::writeSchema()
+{
+	encodeSchema(message_);
+	writeOut(message_);
+}
+
+void ArrowWriter::writeDictionary(int64_t id, Dictionary& dictionary)
+{
+	// a stream starts with every dictionary, later only the new values are sent as deltas
+	if (dictionariesWritten_ and dictionary.values.size() == dictionary.written)
+	{
+		return;
+	}
+
+	const auto count{dictionary.values.size() - dictionary.written};
+	const Node node{count, 0};
+	const Buffer buffers[]{{nullptr, 0}, {dictionary.values.data() + dictionary.written, count * sizeof(uint32_t)}};
+
+	encodeBatch(message_, count, {&node, 1}, buffers, id, dictionary.written != 0);
+	writeOut(message_);
+
+	dictionary.written = dictionary.values.size();
+}
+
+void ArrowWriter::writeRecordBatch()
+{
+	const auto rows{timestamps_.size()};
+	// the validity bitmap is omitted when every row has a 5-tuple
+	const Buffer validity{validity_.data(), nullCount_ != 0 ? validity_.size() : 0};
+
+	const Node nodes[]{{rows, 0}, {rows, 0}, {rows, 0}, {rows, 0}, {rows, nullCount_}, {rows, nullCount_}, {rows, nullCount_}, {rows, nullCount_}, {rows, nullCount_}};
+	const Buffer buffers[]{{nullptr, 0},
+			       {timestamps_.data(), rows * sizeof(int64_t)},
+			       {nullptr, 0},
+			       {lengths_.data(), rows * sizeof(uint32_t)},
+			       {nullptr, 0},
+			       {originalLengths_.data(), rows * sizeof(uint32_t)},
+			       {nullptr, 0},
+			       {linkLayerTypes_.data(), rows * sizeof(uint32_t)},
+			       validity,
+			       {sourceAddresses_.data(), rows * sizeof(int32_t)},
+			       validity,
+			       {destinationAddresses_.data(), rows * sizeof(int32_t)},
+			       validity,
+			       {sourcePorts_.data(), rows * sizeof(uint16_t)},
+			       validity,
+			       {destinationPorts_.data(), rows * sizeof(uint16_t)},
+			       validity,
+			       {protocols_.data(), rows * sizeof(uint8_t)}};
+
+	encodeBatch(message_, rows, nodes, buffers);
+	writeOut(message_);
+}
+
+void ArrowWriter::writeOut(const std::vector<uint8_t>& data)
+{
+	const auto* bytes{data.data()};
+	auto size{data.size()};
+
+	while (size != 0)
+	{
+		const auto result{::write(descriptor_, bytes, size)};
+
+		if (result == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			throw std::runtime_error(std::format("pcap::ArrowWriter [exception]: cannot write '{}': {}.", fileName_, std::strerror(errno)));
+		}
+
+		bytes += result;
+		size -= result;
+	}
+
+	writtenBytes_ += data.size();
+}
+
+int32_t ArrowWriter::encode(Dictionary& dictionary, uint32_t value)
+{
+	const auto [position, inserted]{dictionary.indices.try_emplace(value, static_cast<int32_t>(dictionary.values.size()))};
+
+	if (inserted)
+	{
+		dictionary.values.push_back(value);
+	}
+
+	return position->second;
+}
+} // namespace pcap
@@ -0,0 +1,129 @@
+#ifndef PCAP_ARROW_WRITER_HPP
+#define PCAP_ARROW_WRITER_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pcap/network_layer/five_tuple.hpp"
+
+namespace pcap
+{
+class Packet;
+class PacketBatch;
+
+/**
+ * @brief Writer of packet summaries in the Arrow IPC stream format, readable by Arrow based engines as they are,
+ * e.g. with `pyarrow.ipc.open_stream()`.
+ * 
+ * Every packet is a row of fixed-width columns: `timestamp` (nanoseconds), `captured_length`, `original_length`,
+ * `link_layer_type`, and the IPv4 5-tuple `source_address`, `destination_address`, `source_port`, `destination_port`,
+ * `protocol`, which are null for packets other than Ethernet IPv4 ones. Addresses are dictionary-encoded 32-bit
+ * values in host byte order. Rows are gathered column by column and written in record batches of `batchRows`,
+ * each preceded by the addresses new to the dictionaries. Dictionaries grown past `maxDictionarySize` are replaced
+ * by new ones, which bounds the memory of long captures.
+ */
+class ArrowWriter final
+{
+public:
+	struct Options
+	{
+		uint64_t batchRows{64 * 1024};
+		uint64_t maxDictionarySize{1024 * 1024};
+	};
+
+	explicit ArrowWriter(const std::string& fileName);
+	ArrowWriter(const std::string& fileName, const Options& options);
+	ArrowWriter(const ArrowWriter&) = delete;
+	ArrowWriter(ArrowWriter&&) = delete;
+	ArrowWriter& operator=(const ArrowWriter&) = delete;
+	ArrowWriter& operator=(ArrowWriter&&) = delete;
+
+	/**
+	 * @brief Closes the stream, errors are ignored: call `close()` to get them.
+	 */
+	~ArrowWriter();
+
+	/**
+	 * @brief Adds a packet row, the packet does not have to be parsed. Its original length is taken to be the captured one.
+	 * 
+	 * @param packet Packet
+	 */
+	void write(const Packet& packet);
+
+	/**
+	 * @brief Adds a row per batch packet, 5-tuples are extracted for the whole batch at once.
+	 * 
+	 * @param batch Packet batch
+	 */
+	void write(const PacketBatch& batch);
+
+	/**
+	 * @brief Writes out the gathered rows as a record batch.
+	 */
+	void flush();
+
+	/**
+	 * @brief Writes out the gathered rows, ends the stream and closes the file.
+	 */
+	void close();
+
+	/**
+	 * @brief Returns the number of rows written, including the gathered ones.
+	 * 
+	 * @return Number of rows written
+	 */
+	[[nodiscard]] uint64_t writtenRows() const noexcept;
+
+	/**
+	 * @brief Returns the number of bytes written to the file.
+	 * 
+	 * @return Number of bytes written
+	 */
+	[[nodiscard]] uint64_t writtenBytes() const noexcept;
+
+private:
+	struct Dictionary
+	{
+		std::unordered_map<uint32_t, int32_t> indices;
+		std::vector<uint32_t> values;
+		// values already written to the stream
+		uint64_t written;
+	};
+
+	void append(uint64_t timestamp, uint32_t length, uint32_t originalLength, uint32_t linkLayerType, const FiveTuple& tuple);
+	void writeSchema();
+	void writeDictionary(int64_t id, Dictionary& dictionary);
+	void writeRecordBatch();
+	void writeOut(const std::vector<uint8_t>& data);
+
+	static int32_t encode(Dictionary& dictionary, uint32_t value);
+
+	std::string fileName_;
+	Options options_;
+	std::vector<int64_t> timestamps_;
+	std::vector<uint32_t> lengths_;
+	std::vector<uint32_t> originalLengths_;
+	std::vector<uint32_t> linkLayerTypes_;
+	std::vector<int32_t> sourceAddresses_;
+	std::vector<int32_t> destinationAddresses_;
+	std::vector<uint16_t> sourcePorts_;
+	std::vector<uint16_t> destinationPorts_;
+	std::vector<uint8_t> protocols_;
+	// one bit per row, set for rows with a 5-tuple
+	std::vector<uint8_t> validity_;
+	std::vector<FiveTuple> tuples_;
+	Dictionary sourceDictionary_;
+	Dictionary destinationDictionary_;
+	// encoded message, reused between batches
+	std::vector<uint8_t> message_;
+	uint64_t nullCount_;
+	uint64_t writtenRows_;
+	uint64_t writtenBytes_;
+	int descriptor_;
+	bool dictionariesWritten_;
+};
+} // namespace pcap
+
+#endif // PCAP_ARROW_WRITER_HPP
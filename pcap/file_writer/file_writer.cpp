@@ -0,0 +1,305 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "file_writer.hpp"
+#include "pcap/file_reader/file_reader.hpp"
+#include "pcap/packet/packet.hpp"
+#include "pcap/packet/packet_batch.hpp"
+
+// direct I/O needs buffers, sizes and file offsets aligned to the logical block size, a page covers every common one
+constexpr uint64_t pageSize{4096};
+constexpr uint32_t magicNumberMicroseconds{0xa1b2c3d4};
+constexpr uint32_t magicNumberNanoseconds{0xa1b23c4d};
+
+namespace pcap
+{
+FileWriter::FileWriter(const std::string& fileName) : FileWriter(fileName, Options{}) {}
+
+FileWriter::FileWriter(const std::string& fileName, const Options& options)
+	: buffer_{}
+	, fileName_{fileName}
+	, options_{options}
+	, buffered_{}
+	, writtenBytes_{}
+	, writtenPackets_{}
+	, descriptor_{-1}
+	, directIo_{options.directIo}
+{
+	options_.bufferSize = std::max(pageSize, (options_.bufferSize + pageSize - 1) / pageSize * pageSize);
+
+	constexpr auto flags{O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC};
+
+	if (directIo_)
+	{
+		descriptor_ = ::open(fileName.c_str(), flags | O_DIRECT, 0644);
+
+		// the file system does not support direct I/O
+		if (descriptor_ == -1 and errno == EINVAL)
+		{
+			directIo_ = false;
+		}
+	}
+
+	if (not directIo_)
+	{
+		descriptor_ = ::open(fileName.c_str(), flags, 0644);
+	}
+
+	if (descriptor_ == -1)
+	{
+		throw std::runtime_error(std::format("pcap::FileWriter [exception]: cannot open '{}': {}.", fileName, std::strerror(errno)));
+	}
+
+	buffer_.reset(static_cast<uint8_t*>(std::aligned_alloc(pageSize, options_.bufferSize)));
+
+	if (not buffer_)
+	{
+		::close(descriptor_);
+		throw std::bad_alloc{};
+	}
+
+	const FileReader::FileHeader header{options_.nanoseconds ? magicNumberNanoseconds : magicNumberMicroseconds,
+					    2,
+					    4,
+					    0,
+					    0,
+					    options_.snapLength,
+					    options_.linkLayerType};
+
+	append(&header, sizeof(header));
+}
+
+FileWriter::FileWriter(FileWriter&& writer) noexcept
+	: buffer_{std::move(writer.buffer_)}
+	, fileName_{std::move(writer.fileName_)}
+	, options_{writer.options_}
+	, buffered_{std::exchange(writer.buffered_, 0)}
+	, writtenBytes_{std::exchange(writer.writtenBytes_, 0)}
+	, writtenPackets_{std::exchange(writer.writtenPackets_, 0)}
+	, descriptor_{std::exchange(writer.descriptor_, -1)}
+	, directIo_{writer.directIo_}
+{
+}
+
+FileWriter& FileWriter::operator=(FileWriter&& writer) noexcept
+{
+	if (this != &writer)
+	{
+		try
+		{
+			close();
+		}
+		catch (...)
+		{
+		}
+
+		buffer_ = std::move(writer.buffer_);
+		fileName_ = std::move(writer.fileName_);
+		options_ = writer.options_;
+		buffered_ = std::exchange(writer.buffered_, 0);
+		writtenBytes_ = std::exchange(writer.writtenBytes_, 0);
+		writtenPackets_ = std::exchange(writer.writtenPackets_, 0);
+		descriptor_ = std::exchange(writer.descriptor_, -1);
+		directIo_ = writer.directIo_;
+	}
+
+	return *this;
+}
+
+FileWriter::~FileWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+	}
+}
+
+void FileWriter::write(uint64_t timestamp, std::span<const uint8_t> data, uint32_t originalLength)
+{
+	const auto fraction{timestamp % 1'000'000'000};
+	const FileReader::PacketHeader header{static_cast<uint32_t>(timestamp / 1'000'000'000),
+					      static_cast<uint32_t>(options_.nanoseconds ? fraction : fraction / 1000),
+					      static_cast<uint32_t>(data.size()),
+					      originalLength};
+
+	append(&header, sizeof(header));
+	append(data.data(), data.size());
+	++writtenPackets_;
+}
+
+void FileWriter::write(const Packet& packet)
+{
+	checkLinkLayerType(packet.linkLayerType());
+	write(packet.timestamp(), packet.data(), static_cast<uint32_t>(packet.data().size()));
+}
+
+void FileWriter::write(const PacketBatch& batch)
+{
+	if (batch.empty())
+	{
+		return;
+	}
+
+	const auto linkLayerTypes{batch.linkLayerTypes()};
+	const auto timestamps{batch.timestamps()};
+	const auto originalLengths{batch.originalLengths()};
+
+	if (not batch.holdsRecords(std::endian::native, options_.nanoseconds))
+	{
+		for (uint64_t i{}; i < batch.size(); ++i)
+		{
+			checkLinkLayerType(linkLayerTypes[i]);
+			write(timestamps[i], batch.data(i), originalLengths[i]);
+		}
+
+		return;
+	}
+
+	// a PCAP file has a single link layer type
+	checkLinkLayerType(linkLayerTypes[0]);
+
+	const auto data{batch.data()};
+	const auto offsets{batch.offsets()};
+	const auto lengths{batch.lengths()};
+
+	// packets rejected by a filter leave gaps between the records
+	for (uint64_t i{}; i < batch.size();)
+	{
+		const auto begin{offsets[i] - sizeof(FileReader::PacketHeader)};
+		auto end{static_cast<uint64_t>(offsets[i]) + lengths[i]};
+		auto next{i + 1};
+
+		while (next < batch.size() and offsets[next] - sizeof(FileReader::PacketHeader) == end)
+		{
+			end = static_cast<uint64_t>(offsets[next]) + lengths[next];
+			++next;
+		}
+
+		append(data.data() + begin, end - begin);
+		writtenPackets_ += next - i;
+		i = next;
+	}
+}
+
+void FileWriter::flush()
+{
+	const auto size{directIo_ ? buffered_ / pageSize * pageSize : buffered_};
+
+	writeOut(buffer_.get(), size);
+	std::memmove(buffer_.get(), buffer_.get() + size, buffered_ - size);
+	buffered_ -= size;
+}
+
+void FileWriter::close()
+{
+	if (descriptor_ == -1)
+	{
+		return;
+	}
+
+	try
+	{
+		flush();
+
+		// the tail is not a whole page: it is written past the page cache bypass
+		if (buffered_ != 0)
+		{
+			::fcntl(descriptor_, F_SETFL, ::fcntl(descriptor_, F_GETFL) & ~O_DIRECT);
+			directIo_ = false;
+			flush();
+		}
+	}
+	catch (...)
+	{
+		::close(std::exchange(descriptor_, -1));
+		throw;
+	}
+
+	if (::close(std::exchange(descriptor_, -1)) == -1)
+	{
+		throw std::runtime_error(std::format("pcap::FileWriter [exception]: cannot close '{}': {}.", fileName_, std::strerror(errno)));
+	}
+}
+
+uint64_t FileWriter::writtenBytes() const noexcept
+{
+	return writtenBytes_;
+}
+
+uint64_t FileWriter::writtenPackets() const noexcept
+{
+	return writtenPackets_;
+}
+
+void FileWriter::append(const void* data, uint64_t size)
+{
+	const auto* bytes{static_cast<const uint8_t*>(data)};
+	writtenBytes_ += size;
+
+	while (size != 0)
+	{
+		const auto chunk{std::min(size, options_.bufferSize - buffered_)};
+
+		std::memcpy(buffer_.get() + buffered_, bytes, chunk);
+		buffered_ += chunk;
+		bytes += chunk;
+		size -= chunk;
+
+		if (buffered_ == options_.bufferSize)
+		{
+			writeOut(buffer_.get(), buffered_);
+			buffered_ = 0;
+		}
+
+		// large runs are written straight from the caller's memory, direct I/O needs them aligned and copied
+		if (buffered_ == 0 and not directIo_ and size >= options_.bufferSize)
+		{
+			writeOut(bytes, size);
+			return;
+		}
+	}
+}
+
+void FileWriter::writeOut(const uint8_t* data, uint64_t size)
+{
+	while (size != 0)
+	{
+		const auto result{::write(descriptor_, data, size)};
+
+		if (result == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			throw std::runtime_error(std::format("pcap::FileWriter [exception]: cannot write '{}': {}.", fileName_, std::strerror(errno)));
+		}
+
+		data += result;
+		size -= result;
+	}
+}
+
+void FileWriter::checkLinkLayerType(uint32_t linkLayerType) const
+{
+	if (linkLayerType != options_.linkLayerType)
+	{
+		throw std::runtime_error(std::format("pcap::FileWriter [exception]: cannot write '{}': packet link layer type {} differs from the file one {}.",
+						     fileName_,
+						     linkLayerType,
+						     options_.linkLayerType));
+	}
+}
+} // namespace pcap
@@ -0,0 +1,118 @@
+#ifndef PCAP_FILE_WRITER_HPP
+#define PCAP_FILE_WRITER_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace pcap
+{
+class Packet;
+class PacketBatch;
+
+/**
+ * @brief Writer of PCAP files in the host byte order, using the record layout of `FileReader`.
+ * 
+ * Records are gathered in a large page-aligned buffer and written with one system call per buffer.
+ * With direct I/O the page cache is bypassed, file systems that do not support it get regular writes.
+ */
+class FileWriter final
+{
+public:
+	struct Options
+	{
+		// rounded up to whole pages
+		uint64_t bufferSize{4 * 1024 * 1024};
+		bool directIo{false};
+		bool nanoseconds{true};
+		uint32_t linkLayerType{1};
+		uint32_t snapLength{262144};
+	};
+
+	explicit FileWriter(const std::string& fileName);
+	FileWriter(const std::string& fileName, const Options& options);
+	FileWriter(const FileWriter&) = delete;
+	FileWriter(FileWriter&&) noexcept;
+	FileWriter& operator=(const FileWriter&) = delete;
+	FileWriter& operator=(FileWriter&&) noexcept;
+
+	/**
+	 * @brief Closes the file, errors are ignored: call `close()` to get them.
+	 */
+	~FileWriter();
+
+	/**
+	 * @brief Writes a packet.
+	 * 
+	 * @param timestamp Packet timestamp `nanoseconds`
+	 * @param data Captured packet bytes
+	 * @param originalLength Original packet length
+	 */
+	void write(uint64_t timestamp, std::span<const uint8_t> data, uint32_t originalLength);
+
+	/**
+	 * @brief Writes a packet, its original length is taken to be the captured one.
+	 * 
+	 * @param packet Packet
+	 */
+	void write(const Packet& packet);
+
+	/**
+	 * @brief Writes all batch packets. Records of a PCAP file with the same byte order and timestamp precision
+	 * are passed through as they are, runs of adjacent records are copied at once, large runs bypass the buffer.
+	 * 
+	 * @param batch Packet batch
+	 */
+	void write(const PacketBatch& batch);
+
+	/**
+	 * @brief Writes out the buffered records, only whole pages with direct I/O.
+	 */
+	void flush();
+
+	/**
+	 * @brief Writes out all buffered records and closes the file.
+	 */
+	void close();
+
+	/**
+	 * @brief Returns the number of bytes written, including the buffered ones.
+	 * 
+	 * @return Number of bytes written
+	 */
+	[[nodiscard]] uint64_t writtenBytes() const noexcept;
+
+	/**
+	 * @brief Returns the number of packets written.
+	 * 
+	 * @return Number of packets written
+	 */
+	[[nodiscard]] uint64_t writtenPackets() const noexcept;
+
+private:
+	struct BufferDeleter
+	{
+		void operator()(uint8_t* buffer) const noexcept
+		{
+			std::free(buffer);
+		}
+	};
+
+	void append(const void* data, uint64_t size);
+	void writeOut(const uint8_t* data, uint64_t size);
+	void checkLinkLayerType(uint32_t linkLayerType) const;
+
+	std::unique_ptr<uint8_t, BufferDeleter> buffer_;
+	std::string fileName_;
+	Options options_;
+	uint64_t buffered_;
+	uint64_t writtenBytes_;
+	uint64_t writtenPackets_;
+	int descriptor_;
+	bool directIo_;
+};
+} // namespace pcap
+
+#endif // PCAP_FILE_WRITER_HPP
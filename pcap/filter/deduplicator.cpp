@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <bit>
+
+#include "deduplicator.hpp"
+#include "pcap/utils/batch_decoder.hpp"
+
+namespace pcap
+{
+Deduplicator::Deduplicator() noexcept : buckets_{}, window_{}, duplicates_{} {}
+
+Deduplicator::Deduplicator(const Options& options)
+	: buckets_(std::bit_ceil(std::max(options.capacity, bucketSize)) / bucketSize)
+	, window_{options.window}
+	, duplicates_{}
+{
+}
+
+bool Deduplicator::empty() const noexcept
+{
+	return buckets_.empty();
+}
+
+bool Deduplicator::isDuplicate(std::span<const uint8_t> data, uint32_t linkLayerType, uint64_t timestamp) noexcept
+{
+	if (buckets_.empty())
+	{
+		return false;
+	}
+
+	const auto hash{hashPacket(data, linkLayerType) | 1};
+	// the low bit is always set, the bucket is picked by the high ones
+	auto& bucket{buckets_[(hash >> 32) & (buckets_.size() - 1)]};
+	auto* oldest{&bucket.entries[0]};
+
+	for (auto& entry : bucket.entries)
+	{
+		// captures of several ports are not strictly in time order
+		const auto distance{timestamp > entry.timestamp ? timestamp - entry.timestamp : entry.timestamp - timestamp};
+
+		if (entry.hash == hash and distance <= window_)
+		{
+			++duplicates_;
+			return true;
+		}
+
+		// free entries are the oldest ones
+		if (entry.hash == 0 or (oldest->hash != 0 and entry.timestamp < oldest->timestamp))
+		{
+			oldest = &entry;
+		}
+	}
+
+	*oldest = Entry{hash, timestamp};
+
+	return false;
+}
+
+uint64_t Deduplicator::duplicates() const noexcept
+{
+	return duplicates_;
+}
+} // namespace pcap
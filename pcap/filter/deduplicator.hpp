@@ -0,0 +1,88 @@
+#ifndef PCAP_FILTER_DEDUPLICATOR_HPP
+#define PCAP_FILTER_DEDUPLICATOR_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pcap
+{
+/**
+ * @brief Drops copies of a packet seen within a time window, e.g. the ones captured on several mirrored ports.
+ * 
+ * Packets are compared by `hashPacket()`, so copies that only differ in the link header, the IPv4 TTL or the header
+ * checksum are duplicates too. Hashes are remembered in a fixed table of 4-entry buckets: a new hash replaces the
+ * oldest entry of its bucket, which bounds the memory whatever the capture rate, at the cost of missing duplicates
+ * whose original was evicted.
+ */
+class Deduplicator final
+{
+public:
+	struct Options
+	{
+		// a packet duplicates the same packet seen at most `window` nanoseconds before or after it
+		uint64_t window{1'000'000};
+		// remembered packets, rounded up to a power of two: the table takes `16 * capacity` bytes
+		uint64_t capacity{256 * 1024};
+	};
+
+	/**
+	 * @brief Creates an empty deduplicator, which finds no duplicates.
+	 */
+	Deduplicator() noexcept;
+
+	/**
+	 * @brief Creates a deduplicator.
+	 * 
+	 * @param options Window and capacity
+	 */
+	explicit Deduplicator(const Options& options);
+
+	/**
+	 * @brief Checks whether the deduplicator is empty.
+	 * 
+	 * @return `True` if the deduplicator finds no duplicates, otherwise - `false`
+	 */
+	[[nodiscard]] bool empty() const noexcept;
+
+	/**
+	 * @brief Checks whether a packet duplicates one seen within the window, otherwise remembers it.
+	 * 
+	 * @param data Captured packet bytes
+	 * @param linkLayerType Link layer type
+	 * @param timestamp Packet timestamp `nanoseconds`
+	 * 
+	 * @return `True` if the packet is a duplicate, otherwise - `false`
+	 */
+	[[nodiscard]] bool isDuplicate(std::span<const uint8_t> data, uint32_t linkLayerType, uint64_t timestamp) noexcept;
+
+	/**
+	 * @brief Returns the number of duplicates found.
+	 * 
+	 * @return Number of duplicates
+	 */
+	[[nodiscard]] uint64_t duplicates() const noexcept;
+
+private:
+	struct Entry
+	{
+		// zero marks a free entry
+		uint64_t hash;
+		uint64_t timestamp;
+	};
+
+	static constexpr uint64_t bucketSize{4};
+
+	// a bucket fills a cache line
+	struct alignas(64) Bucket
+	{
+		Entry entries[bucketSize];
+	};
+
+	std::vector<Bucket> buckets_;
+	uint64_t window_;
+	uint64_t duplicates_;
+};
+} // namespace pcap
+
+#endif // PCAP_FILTER_DEDUPLICATOR_HPP
@@ -0,0 +1,577 @@
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "filter.hpp"
+#include "pcap/network_layer/views.hpp"
+
+constexpr uint8_t protocolTcp{6};
+constexpr uint8_t protocolUdp{17};
+
+namespace pcap
+{
+namespace
+{
+enum class Direction : uint8_t
+{
+	any,
+	source,
+	destination
+};
+
+class Parser final
+{
+public:
+	using Predicate = std::function<bool(const Filter::Fields&)>;
+
+	explicit Parser(const std::string& expression) : expression_{expression}, tokens_{tokenize(expression)}, position_{} {}
+
+	Predicate parse()
+	{
+		auto predicate{parseOr()};
+
+		if (position_ != tokens_.size())
+		{
+			fail(std::format("unexpected '{}'", tokens_[position_]));
+		}
+
+		return predicate;
+	}
+
+private:
+	static std::vector<std::string_view> tokenize(std::string_view expression)
+	{
+		std::vector<std::string_view> tokens{};
+
+		for (uint64_t i{}; i < expression.size();)
+		{
+			if (std::isspace(static_cast<unsigned char>(expression[i])))
+			{
+				++i;
+				continue;
+			}
+
+			if (expression.substr(i, 2) == "&&" or expression.substr(i, 2) == "||" or expression.substr(i, 2) == "<=" or
+			    expression.substr(i, 2) == ">=" or expression.substr(i, 2) == "==" or expression.substr(i, 2) == "!=")
+			{
+				tokens.push_back(expression.substr(i, 2));
+				i += 2;
+				continue;
+			}
+
+			if (std::string_view{"()!<>="}.find(expression[i]) != std::string_view::npos)
+			{
+				tokens.push_back(expression.substr(i, 1));
+				++i;
+				continue;
+			}
+
+			const auto begin{i};
+
+			while (i < expression.size() and not std::isspace(static_cast<unsigned char>(expression[i])) and
+			       std::string_view{"()!<>=&|"}.find(expression[i]) == std::string_view::npos)
+			{
+				++i;
+			}
+
+			tokens.push_back(expression.substr(begin, i - begin));
+		}
+
+		return tokens;
+	}
+
+	Predicate parseOr()
+	{
+		auto predicate{parseAnd()};
+
+		while (accept("or") or accept("||"))
+		{
+			predicate = [left = std::move(predicate), right = parseAnd()](const Filter::Fields& fields) { return left(fields) or right(fields); };
+		}
+
+		return predicate;
+	}
+
+	Predicate parseAnd()
+	{
+		auto predicate{parseNot()};
+
+		while (accept("and") or accept("&&"))
+		{
+			predicate = [left = std::move(predicate), right = parseNot()](const Filter::Fields& fields) { return left(fields) and right(fields); };
+		}
+
+		return predicate;
+	}
+
+	Predicate parseNot()
+	{
+		if (accept("not") or accept("!"))
+		{
+			return [operand = parseNot()](const Filter::Fields& fields) { return not operand(fields); };
+		}
+
+		if (accept("("))
+		{
+			auto predicate{parseOr()};
+			expect(")");
+
+			return predicate;
+		}
+
+		return parsePrimitive();
+	}
+
+	Predicate parsePrimitive()
+	{
+		if (accept("len"))
+		{
+			return parseLength();
+		}
+
+		if (accept("less"))
+		{
+			return [length = parseNumber(UINT32_MAX)](const Filter::Fields& fields) { return fields.length <= length; };
+		}
+
+		if (accept("greater"))
+		{
+			return [length = parseNumber(UINT32_MAX)](const Filter::Fields& fields) { return fields.length >= length; };
+		}
+
+		if (accept("vlan"))
+		{
+			if (position_ < tokens_.size() and std::isdigit(static_cast<unsigned char>(tokens_[position_].front())))
+			{
+				return [identifier = static_cast<uint16_t>(parseNumber(0x0fff))](const Filter::Fields& fields)
+				{ return fields.vlan and fields.vlanIdentifier == identifier; };
+			}
+
+			return [](const Filter::Fields& fields) { return fields.vlan; };
+		}
+
+		if (accept("ip6"))
+		{
+			if (accept("proto"))
+			{
+				return [protocol = parseProtocol()](const Filter::Fields& fields) { return fields.ipv6 and fields.protocol == protocol; };
+			}
+
+			return [](const Filter::Fields& fields) { return fields.ipv6; };
+		}
+
+		std::optional<uint8_t> protocol{};
+
+		if (accept("ip"))
+		{
+			if (accept("proto"))
+			{
+				return [protocol = parseProtocol()](const Filter::Fields& fields) { return fields.ipv4 and fields.protocol == protocol; };
+			}
+
+			if (not startsQualifiedPrimitive())
+			{
+				return [](const Filter::Fields& fields) { return fields.ipv4; };
+			}
+		}
+		else if (accept("udp"))
+		{
+			protocol = protocolUdp;
+		}
+		else if (accept("tcp"))
+		{
+			protocol = protocolTcp;
+		}
+
+		if (protocol and not startsQualifiedPrimitive())
+		{
+			return [protocol = *protocol](const Filter::Fields& fields) { return (fields.ipv4 or fields.ipv6) and fields.protocol == protocol; };
+		}
+
+		auto direction{Direction::any};
+
+		if (accept("src"))
+		{
+			direction = Direction::source;
+		}
+		else if (accept("dst"))
+		{
+			direction = Direction::destination;
+		}
+
+		if (accept("host"))
+		{
+			const auto address{parseAddress()};
+
+			return addressPredicate(direction, protocol, address, UINT32_MAX);
+		}
+
+		if (accept("net"))
+		{
+			const auto [address, mask]{parseNetwork()};
+
+			return addressPredicate(direction, protocol, address, mask);
+		}
+
+		if (accept("port"))
+		{
+			const auto port{static_cast<uint16_t>(parseNumber(UINT16_MAX))};
+
+			return portPredicate(direction, protocol, port, port);
+		}
+
+		if (accept("portrange"))
+		{
+			const auto range{next()};
+			const auto separator{range.find('-')};
+
+			if (separator == std::string_view::npos)
+			{
+				fail(std::format("invalid port range '{}'", range));
+			}
+
+			const auto first{static_cast<uint16_t>(toNumber(range.substr(0, separator), UINT16_MAX))};
+			const auto last{static_cast<uint16_t>(toNumber(range.substr(separator + 1), UINT16_MAX))};
+
+			return portPredicate(direction, protocol, first, last);
+		}
+
+		fail(position_ < tokens_.size() ? std::format("unexpected '{}'", tokens_[position_]) : "unexpected end of expression");
+	}
+
+	Predicate parseLength()
+	{
+		const auto operation{next()};
+		const auto length{parseNumber(UINT32_MAX)};
+
+		if (operation == "<=")
+		{
+			return [length](const Filter::Fields& fields) { return fields.length <= length; };
+		}
+
+		if (operation == ">=")
+		{
+			return [length](const Filter::Fields& fields) { return fields.length >= length; };
+		}
+
+		if (operation == "<")
+		{
+			return [length](const Filter::Fields& fields) { return fields.length < length; };
+		}
+
+		if (operation == ">")
+		{
+			return [length](const Filter::Fields& fields) { return fields.length > length; };
+		}
+
+		if (operation == "=" or operation == "==")
+		{
+			return [length](const Filter::Fields& fields) { return fields.length == length; };
+		}
+
+		if (operation == "!=")
+		{
+			return [length](const Filter::Fields& fields) { return fields.length != length; };
+		}
+
+		fail(std::format("unknown comparison '{}'", operation));
+	}
+
+	static Predicate addressPredicate(Direction direction, std::optional<uint8_t> protocol, uint32_t address, uint32_t mask)
+	{
+		// without a protocol qualifier addresses match any IPv4 packet
+		const auto any{not protocol.has_value()};
+		const auto expected{protocol.value_or(0)};
+		address &= mask;
+
+		switch (direction)
+		{
+		case Direction::source:
+			return [any, expected, address, mask](const Filter::Fields& fields)
+			{ return fields.ipv4 and (any or fields.protocol == expected) and (fields.sourceAddress & mask) == address; };
+		case Direction::destination:
+			return [any, expected, address, mask](const Filter::Fields& fields)
+			{ return fields.ipv4 and (any or fields.protocol == expected) and (fields.destinationAddress & mask) == address; };
+		default:
+			return [any, expected, address, mask](const Filter::Fields& fields)
+			{
+				return fields.ipv4 and (any or fields.protocol == expected) and
+				       ((fields.sourceAddress & mask) == address or (fields.destinationAddress & mask) == address);
+			};
+		}
+	}
+
+	static Predicate portPredicate(Direction direction, std::optional<uint8_t> protocol, uint16_t first, uint16_t last)
+	{
+		// without a protocol qualifier ports match both UDP and TCP
+		const auto any{not protocol.has_value()};
+		const auto expected{protocol.value_or(0)};
+
+		switch (direction)
+		{
+		case Direction::source:
+			return [any, expected, first, last](const Filter::Fields& fields)
+			{ return fields.ports and (any or fields.protocol == expected) and fields.sourcePort >= first and fields.sourcePort <= last; };
+		case Direction::destination:
+			return [any, expected, first, last](const Filter::Fields& fields) {
+				return fields.ports and (any or fields.protocol == expected) and fields.destinationPort >= first and
+				       fields.destinationPort <= last;
+			};
+		default:
+			return [any, expected, first, last](const Filter::Fields& fields)
+			{
+				return fields.ports and (any or fields.protocol == expected) and
+				       ((fields.sourcePort >= first and fields.sourcePort <= last) or
+					(fields.destinationPort >= first and fields.destinationPort <= last));
+			};
+		}
+	}
+
+	bool startsQualifiedPrimitive() const noexcept
+	{
+		if (position_ == tokens_.size())
+		{
+			return false;
+		}
+
+		const auto token{tokens_[position_]};
+
+		return token == "src" or token == "dst" or token == "host" or token == "net" or token == "port" or token == "portrange";
+	}
+
+	uint8_t parseProtocol()
+	{
+		if (accept("udp"))
+		{
+			return protocolUdp;
+		}
+
+		if (accept("tcp"))
+		{
+			return protocolTcp;
+		}
+
+		return static_cast<uint8_t>(parseNumber(UINT8_MAX));
+	}
+
+	uint32_t parseAddress()
+	{
+		const auto token{next()};
+		const auto address{toAddress(token)};
+
+		if (not address)
+		{
+			fail(std::format("invalid IPv4 address '{}'", token));
+		}
+
+		return *address;
+	}
+
+	std::pair<uint32_t, uint32_t> parseNetwork()
+	{
+		const auto token{next()};
+		const auto separator{token.find('/')};
+		const auto address{toAddress(token.substr(0, separator))};
+
+		if (not address)
+		{
+			fail(std::format("invalid IPv4 network '{}'", token));
+		}
+
+		if (separator == std::string_view::npos)
+		{
+			return {*address, UINT32_MAX};
+		}
+
+		const auto length{toNumber(token.substr(separator + 1), 32)};
+
+		return {*address, length == 0 ? 0 : UINT32_MAX << (32 - length)};
+	}
+
+	uint32_t parseNumber(uint32_t maximum)
+	{
+		return toNumber(next(), maximum);
+	}
+
+	uint32_t toNumber(std::string_view token, uint32_t maximum) const
+	{
+		uint32_t value{};
+		const auto [end, error]{std::from_chars(token.data(), token.data() + token.size(), value)};
+
+		if (error != std::errc{} or end != token.data() + token.size() or value > maximum)
+		{
+			fail(std::format("invalid number '{}'", token));
+		}
+
+		return value;
+	}
+
+	static std::optional<uint32_t> toAddress(std::string_view token) noexcept
+	{
+		uint32_t address{};
+
+		for (auto i{0}; i < 4; ++i)
+		{
+			uint32_t octet{};
+			const auto [end, error]{std::from_chars(token.data(), token.data() + token.size(), octet)};
+
+			if (error != std::errc{} or octet > 255)
+			{
+				return std::nullopt;
+			}
+
+			address = (address << 8) | octet;
+			token.remove_prefix(end - token.data());
+
+			if (i < 3)
+			{
+				if (token.empty() or token.front() != '.')
+				{
+					return std::nullopt;
+				}
+
+				token.remove_prefix(1);
+			}
+		}
+
+		if (not token.empty())
+		{
+			return std::nullopt;
+		}
+
+		return address;
+	}
+
+	bool accept(std::string_view token) noexcept
+	{
+		if (position_ < tokens_.size() and tokens_[position_] == token)
+		{
+			++position_;
+			return true;
+		}
+
+		return false;
+	}
+
+	void expect(std::string_view token)
+	{
+		if (not accept(token))
+		{
+			fail(std::format("'{}' expected", token));
+		}
+	}
+
+	std::string_view next()
+	{
+		if (position_ == tokens_.size())
+		{
+			fail("unexpected end of expression");
+		}
+
+		return tokens_[position_++];
+	}
+
+	[[noreturn]] void fail(const std::string& message) const
+	{
+		throw std::runtime_error(std::format("pcap::Filter [exception]: cannot compile '{}': {}", expression_, message));
+	}
+
+	const std::string& expression_;
+	std::vector<std::string_view> tokens_;
+	uint64_t position_;
+};
+} // namespace
+
+Filter::Filter() noexcept : predicate_{} {}
+
+Filter::Filter(const std::string& expression) : predicate_{}
+{
+	if (expression.find_first_not_of(" \t\r\n") != std::string::npos)
+	{
+		predicate_ = Parser{expression}.parse();
+	}
+}
+
+bool Filter::empty() const noexcept
+{
+	return not predicate_;
+}
+
+bool Filter::operator()(std::span<const uint8_t> data, uint32_t linkLayerType) const
+{
+	return not predicate_ or predicate_(decode(data, linkLayerType));
+}
+
+Filter::Fields Filter::decode(std::span<const uint8_t> data, uint32_t linkLayerType) noexcept
+{
+	Fields fields{};
+	fields.length = static_cast<uint32_t>(data.size());
+
+	if (networkLayerTypeOfLinkLayer(linkLayerType) != NetworkLayerType::ethernet or not network_layer::EthernetView::valid(data))
+	{
+		return fields;
+	}
+
+	const network_layer::EthernetView ethernet{data};
+	auto networkLayerType{ethernet.nextLayerType()};
+
+	data = data.subspan(ethernet.headerLength());
+
+	// stacked tags are skipped, the outer one identifies the VLAN
+	while (networkLayerType == NetworkLayerType::vlan and network_layer::VlanView::valid(data))
+	{
+		const network_layer::VlanView vlan{data};
+
+		if (not fields.vlan)
+		{
+			fields.vlan = true;
+			fields.vlanIdentifier = vlan.identifier();
+		}
+
+		networkLayerType = vlan.nextLayerType();
+		data = data.subspan(vlan.headerLength());
+	}
+
+	auto firstFragment{true};
+
+	if (networkLayerType == NetworkLayerType::ip_v4 and network_layer::IPv4View::valid(data))
+	{
+		const network_layer::IPv4View ipv4{data};
+
+		fields.ipv4 = true;
+		fields.protocol = ipv4.protocol();
+		fields.sourceAddress = ipv4.sourceAddress();
+		fields.destinationAddress = ipv4.destinationAddress();
+		firstFragment = ipv4.fragmentOffset() == 0;
+
+		data = data.subspan(ipv4.headerLength());
+	}
+	else if (networkLayerType == NetworkLayerType::ip_v6 and network_layer::IPv6View::valid(data))
+	{
+		const network_layer::IPv6View ipv6{data};
+
+		fields.ipv6 = true;
+		fields.protocol = ipv6.nextHeader();
+
+		data = data.subspan(ipv6.headerLength());
+	}
+	else
+	{
+		return fields;
+	}
+
+	// UDP and TCP headers both start with the ports, only the first fragment carries them
+	if ((fields.protocol == protocolUdp or fields.protocol == protocolTcp) and firstFragment and data.size() >= 2 * sizeof(uint16_t))
+	{
+		fields.ports = true;
+		fields.sourcePort = network_layer::load<uint16_t>(data, 0);
+		fields.destinationPort = network_layer::load<uint16_t>(data, 2);
+	}
+
+	return fields;
+}
+} // namespace pcap
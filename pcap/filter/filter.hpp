@@ -0,0 +1,90 @@
+#ifndef PCAP_FILTER_FILTER_HPP
+#define PCAP_FILTER_FILTER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+
+namespace pcap
+{
+/**
+ * @brief Packet filter compiled once from a BPF-style expression into a tree of closures,
+ * evaluated directly on raw captured bytes.
+ * 
+ * Supported primitives, combined with `and`/`&&`, `or`/`||`, `not`/`!` and parentheses:
+ * `ip`, `ip6`, `udp`, `tcp`, `ip proto <number|udp|tcp>`, `ip6 proto <number|udp|tcp>`, `vlan [<identifier>]`,
+ * `[udp|tcp] [src|dst] host <address>`, `[udp|tcp] [src|dst] net <address>/<length>`, `[udp|tcp] [src|dst] port <number>`,
+ * `[udp|tcp] [src|dst] portrange <first>-<last>`, `len <op> <number>`, `less <number>`, `greater <number>`.
+ * 
+ * VLAN tags are skipped before the network layer, `vlan <identifier>` matches the outer tag. Addresses are IPv4 only,
+ * protocols and ports match over IPv4 and IPv6; IPv6 extension headers are not walked.
+ */
+class Filter final
+{
+public:
+	/**
+	 * @brief Packet fields the filter is evaluated on, decoded once per packet.
+	 */
+	struct Fields
+	{
+		uint32_t length;
+		uint32_t sourceAddress;
+		uint32_t destinationAddress;
+		uint16_t sourcePort;
+		uint16_t destinationPort;
+		uint16_t vlanIdentifier;
+		uint8_t protocol;
+		bool vlan;
+		bool ipv4;
+		bool ipv6;
+		bool ports;
+	};
+
+	/**
+	 * @brief Creates an empty filter, which accepts every packet.
+	 */
+	Filter() noexcept;
+
+	/**
+	 * @brief Compiles a filter expression.
+	 * 
+	 * @param expression Filter expression
+	 */
+	explicit Filter(const std::string& expression);
+
+	/**
+	 * @brief Checks whether the filter is empty.
+	 * 
+	 * @return `True` if the filter accepts every packet, otherwise - `false`
+	 */
+	[[nodiscard]] bool empty() const noexcept;
+
+	/**
+	 * @brief Evaluates the filter on raw packet bytes.
+	 * 
+	 * @param data Captured packet bytes
+	 * @param linkLayerType Link layer type
+	 * 
+	 * @return `True` if the packet is accepted, otherwise - `false`
+	 */
+	[[nodiscard]] bool operator()(std::span<const uint8_t> data, uint32_t linkLayerType) const;
+
+	/**
+	 * @brief Decodes the fields the filter is evaluated on.
+	 * 
+	 * @param data Captured packet bytes
+	 * @param linkLayerType Link layer type
+	 * 
+	 * @return Packet fields
+	 */
+	[[nodiscard]] static Fields decode(std::span<const uint8_t> data, uint32_t linkLayerType) noexcept;
+
+private:
+	using Predicate = std::function<bool(const Fields&)>;
+
+	Predicate predicate_;
+};
+} // namespace pcap
+
+#endif // PCAP_FILTER_FILTER_HPP
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+
+#include "flow_aggregator.hpp"
+#include "pcap/packet/packet_batch.hpp"
+#include "pcap/utils/spsc_ring.hpp"
+
+namespace pcap
+{
+namespace
+{
+struct Record
+{
+	FiveTuple key;
+	uint64_t timestamp;
+	uint32_t length;
+	// asks the shard to copy its table instead of accounting a packet
+	bool snapshot;
+};
+
+struct Shard
+{
+	explicit Shard(const FlowAggregator::Options& options)
+		: ring{options.ringCapacity}
+		, table{options.table}
+		, snapshot{options.table}
+		, exception{}
+	{
+	}
+
+	SpscRing<Record> ring;
+	FlowTable table;
+	FlowTable snapshot;
+	std::exception_ptr exception;
+};
+
+void process(Shard& shard, const Record& record, std::atomic<uint32_t>& pendingSnapshots)
+{
+	// after a failure the records are still consumed, so the reading thread never waits for this shard forever
+	if (not shard.exception)
+	{
+		try
+		{
+			if (record.snapshot)
+			{
+				shard.snapshot = shard.table;
+			}
+			else
+			{
+				shard.table.add(record.key, record.timestamp, record.length);
+			}
+		}
+		catch (...)
+		{
+			shard.exception = std::current_exception();
+		}
+	}
+
+	if (record.snapshot)
+	{
+		pendingSnapshots.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+void work(std::stop_token stopToken, Shard& shard, std::atomic<uint32_t>& pendingSnapshots)
+{
+	Record record{};
+
+	while (true)
+	{
+		if (shard.ring.pop(record))
+		{
+			process(shard, record, pendingSnapshots);
+			continue;
+		}
+
+		if (stopToken.stop_requested())
+		{
+			// the reading thread has pushed everything before requesting the stop
+			while (shard.ring.pop(record))
+			{
+				process(shard, record, pendingSnapshots);
+			}
+
+			return;
+		}
+
+		std::this_thread::yield();
+	}
+}
+
+void push(Shard& shard, const Record& record)
+{
+	while (not shard.ring.push(record))
+	{
+		std::this_thread::yield();
+	}
+}
+
+// flow tables take slots from the low hash bits, shards from the high ones
+uint64_t shardIndex(uint64_t hash, uint64_t shards) noexcept
+{
+	return ((hash >> 32) * shards) >> 32;
+}
+} // namespace
+
+FlowAggregator::FlowAggregator(const std::string& fileName) : FlowAggregator(fileName, Options{}) {}
+
+FlowAggregator::FlowAggregator(const std::string& fileName, const Options& options)
+	: reader_{fileName, options.reader}
+	, options_{options}
+{
+	if (options_.shards == 0)
+	{
+		options_.shards = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	options_.batchPackets = std::max<uint64_t>(1, options_.batchPackets);
+}
+
+uint64_t FlowAggregator::run(FlowTable& flows, std::vector<FlowTable::Flow>& evictedFlows, const SnapshotCallback& snapshot)
+{
+	std::vector<std::unique_ptr<Shard>> shards;
+	std::atomic<uint32_t> pendingSnapshots{};
+	uint64_t packets{};
+
+	for (uint32_t i{}; i < options_.shards; ++i)
+	{
+		shards.push_back(std::make_unique<Shard>(options_));
+	}
+
+	{
+		std::vector<std::jthread> workers;
+		workers.reserve(options_.shards);
+
+		for (auto& shard : shards)
+		{
+			workers.emplace_back(work, std::ref(*shard), std::ref(pendingSnapshots));
+		}
+
+		// the workers are stopped and joined when leaving the scope, also when reading throws
+		PacketBatch batch;
+		std::vector<FiveTuple> tuples;
+		FlowTable merged{options_.table};
+		auto nextSnapshot{options_.snapshotPackets};
+
+		while (reader_.readBatch(batch, options_.batchPackets))
+		{
+			batch.fiveTuples(tuples);
+
+			const auto timestamps{batch.timestamps()};
+			const auto lengths{batch.lengths()};
+
+			for (uint64_t i{}; i < tuples.size(); ++i)
+			{
+				if (tuples[i].valid)
+				{
+					auto& shard{*shards[shardIndex(std::hash<FiveTuple>{}(tuples[i]), shards.size())]};
+					push(shard, Record{tuples[i], timestamps[i], lengths[i], false});
+				}
+			}
+
+			packets += batch.size();
+
+			if (nextSnapshot != 0 and packets >= nextSnapshot and snapshot)
+			{
+				pendingSnapshots.store(options_.shards, std::memory_order_relaxed);
+
+				for (auto& shard : shards)
+				{
+					push(*shard, Record{{}, 0, 0, true});
+				}
+
+				while (pendingSnapshots.load(std::memory_order_acquire) != 0)
+				{
+					std::this_thread::yield();
+				}
+
+				merged.clear();
+
+				for (const auto& shard : shards)
+				{
+					merged.merge(shard->snapshot);
+				}
+
+				snapshot(merged, packets);
+				nextSnapshot = packets + options_.snapshotPackets;
+			}
+		}
+	}
+
+	flows.clear();
+	evictedFlows.clear();
+
+	std::vector<FlowTable::Flow> evicted;
+
+	for (auto& shard : shards)
+	{
+		if (shard->exception)
+		{
+			std::rethrow_exception(shard->exception);
+		}
+
+		flows.merge(shard->table);
+		shard->table.takeEvicted(evicted);
+		evictedFlows.insert(evictedFlows.end(), evicted.begin(), evicted.end());
+	}
+
+	return packets;
+}
+
+void FlowAggregator::setFilter(Filter filter) noexcept
+{
+	reader_.setFilter(std::move(filter));
+}
+} // namespace pcap
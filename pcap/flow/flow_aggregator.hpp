@@ -0,0 +1,76 @@
+#ifndef PCAP_FLOW_FLOW_AGGREGATOR_HPP
+#define PCAP_FLOW_FLOW_AGGREGATOR_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "flow_table.hpp"
+#include "pcap/file_reader/file_reader.hpp"
+
+namespace pcap
+{
+/**
+ * @brief Multi-core flow aggregation: the calling thread reads batches and extracts 5-tuples, packets are
+ * sharded by 5-tuple hash over lock-free single-producer single-consumer rings to worker threads,
+ * each owning a flow table.
+ * 
+ * A flow always lands in the same shard, so shard tables never share flows and merging them needs no locks.
+ */
+class FlowAggregator final
+{
+public:
+	struct Options
+	{
+		// zero selects the number of hardware threads
+		uint32_t shards{0};
+		uint64_t batchPackets{4096};
+		// packets each ring holds
+		uint64_t ringCapacity{16 * 1024};
+		// a merged snapshot is taken every this many packets, zero disables snapshots
+		uint64_t snapshotPackets{0};
+		FlowTable::Options table{};
+		FileReader::Options reader{.mode = FileReader::Mode::memoryMapped};
+	};
+
+	/**
+	 * @brief Callback receiving a merged snapshot of all shard tables and the number of packets read so far.
+	 */
+	using SnapshotCallback = std::function<void(const FlowTable&, uint64_t)>;
+
+	explicit FlowAggregator(const std::string& fileName);
+	FlowAggregator(const std::string& fileName, const Options& options);
+	FlowAggregator(const FlowAggregator&) = delete;
+	FlowAggregator(FlowAggregator&&) noexcept = default;
+	FlowAggregator& operator=(const FlowAggregator&) = delete;
+	FlowAggregator& operator=(FlowAggregator&&) noexcept = default;
+
+	/**
+	 * @brief Reads the whole file and aggregates its flows.
+	 * 
+	 * Snapshots are taken between batches: the reading pauses until every shard has copied its table,
+	 * the callback is invoked on the calling thread.
+	 * 
+	 * @param flows Flows not evicted by the end of the file, the table is cleared first
+	 * @param evictedFlows Flows evicted for being idle, replaced
+	 * @param snapshot Snapshot callback
+	 * 
+	 * @return Number of packets read
+	 */
+	uint64_t run(FlowTable& flows, std::vector<FlowTable::Flow>& evictedFlows, const SnapshotCallback& snapshot = {});
+
+	/**
+	 * @brief Sets the packet filter, packets it rejects are not aggregated.
+	 * 
+	 * @param filter Packet filter
+	 */
+	void setFilter(Filter filter) noexcept;
+
+private:
+	FileReader reader_;
+	Options options_;
+};
+} // namespace pcap
+
+#endif // PCAP_FLOW_FLOW_AGGREGATOR_HPP
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <bit>
+
+#include "flow_table.hpp"
+#include "pcap/packet/packet.hpp"
+#include "pcap/packet/packet_batch.hpp"
+#include "pcap/utils/batch_decoder.hpp"
+
+constexpr uint64_t minimumCapacity{16};
+// slots of the packets this far ahead in a batch are prefetched while the current packet is accounted
+constexpr uint64_t prefetchDistance{8};
+
+namespace pcap
+{
+FlowTable::FlowTable() : FlowTable{Options{}} {}
+
+FlowTable::FlowTable(const Options& options)
+	: slots_(std::bit_ceil(std::max(options.capacity, minimumCapacity)))
+	, spare_{}
+	, evicted_{}
+	, tuples_{}
+	, hashes_{}
+	, mask_{slots_.size() - 1}
+	, size_{}
+	, idleTimeout_{options.idleTimeout}
+	, nextEviction_{}
+{
+}
+
+void FlowTable::add(const FiveTuple& key, uint64_t timestamp, uint32_t length)
+{
+	if (key.valid)
+	{
+		update(key, std::hash<FiveTuple>{}(key), timestamp, length);
+	}
+}
+
+void FlowTable::add(const Packet& packet)
+{
+	add(extractFiveTuple(packet.data(), packet.linkLayerType()), packet.timestamp(), packet.size());
+}
+
+void FlowTable::add(const PacketBatch& batch)
+{
+	batch.fiveTuples(tuples_);
+	hashes_.resize(tuples_.size());
+
+	for (uint64_t i{}; i < tuples_.size(); ++i)
+	{
+		hashes_[i] = std::hash<FiveTuple>{}(tuples_[i]);
+	}
+
+	const auto timestamps{batch.timestamps()};
+	const auto lengths{batch.lengths()};
+
+	for (uint64_t i{}; i < tuples_.size(); ++i)
+	{
+		if (i + prefetchDistance < tuples_.size())
+		{
+			__builtin_prefetch(&slots_[hashes_[i + prefetchDistance] & mask_], 1);
+		}
+
+		if (tuples_[i].valid)
+		{
+			update(tuples_[i], hashes_[i], timestamps[i], lengths[i]);
+		}
+	}
+}
+
+void FlowTable::merge(const Flow& flow)
+{
+	auto& target{emplace(flow.key, std::hash<FiveTuple>{}(flow.key))};
+
+	target.packets += flow.packets;
+	target.bytes += flow.bytes;
+	target.firstTimestamp = std::min(target.firstTimestamp, flow.firstTimestamp);
+	target.lastTimestamp = std::max(target.lastTimestamp, flow.lastTimestamp);
+}
+
+void FlowTable::merge(const FlowTable& table)
+{
+	table.forEach([this](const Flow& flow) { merge(flow); });
+}
+
+void FlowTable::evict(uint64_t timestamp)
+{
+	if (idleTimeout_ == 0)
+	{
+		return;
+	}
+
+	// linear probing cannot leave holes in probe sequences: the remaining flows are reinserted into clean slots
+	spare_.assign(slots_.size(), Flow{});
+	size_ = 0;
+
+	for (const auto& flow : slots_)
+	{
+		if (flow.packets == 0)
+		{
+			continue;
+		}
+
+		if (flow.lastTimestamp + idleTimeout_ <= timestamp)
+		{
+			evicted_.push_back(flow);
+			continue;
+		}
+
+		insert(spare_, flow);
+		++size_;
+	}
+
+	slots_.swap(spare_);
+	// a full sweep is not worth doing more often than a fraction of the timeout
+	nextEviction_ = timestamp + std::max<uint64_t>(idleTimeout_ / 4, 1);
+}
+
+void FlowTable::takeEvicted(std::vector<Flow>& flows)
+{
+	flows.clear();
+	flows.swap(evicted_);
+}
+
+const FlowTable::Flow* FlowTable::find(const FiveTuple& key) const noexcept
+{
+	for (auto slot{std::hash<FiveTuple>{}(key) & mask_};; slot = (slot + 1) & mask_)
+	{
+		const auto& flow{slots_[slot]};
+
+		if (flow.packets == 0)
+		{
+			return nullptr;
+		}
+
+		if (flow.key == key)
+		{
+			return &flow;
+		}
+	}
+}
+
+uint64_t FlowTable::size() const noexcept
+{
+	return size_;
+}
+
+uint64_t FlowTable::capacity() const noexcept
+{
+	return slots_.size();
+}
+
+void FlowTable::clear() noexcept
+{
+	std::fill(slots_.begin(), slots_.end(), Flow{});
+	evicted_.clear();
+	size_ = 0;
+	nextEviction_ = 0;
+}
+
+void FlowTable::update(const FiveTuple& key, uint64_t hash, uint64_t timestamp, uint32_t length)
+{
+	if (idleTimeout_ != 0 and timestamp >= nextEviction_)
+	{
+		evict(timestamp);
+	}
+
+	auto& flow{emplace(key, hash)};
+
+	++flow.packets;
+	flow.bytes += length;
+	flow.firstTimestamp = std::min(flow.firstTimestamp, timestamp);
+	flow.lastTimestamp = std::max(flow.lastTimestamp, timestamp);
+}
+
+FlowTable::Flow& FlowTable::emplace(const FiveTuple& key, uint64_t hash)
+{
+	if ((size_ + 1) * 4 > slots_.size() * 3)
+	{
+		rehash(slots_.size() * 2);
+	}
+
+	for (auto slot{hash & mask_};; slot = (slot + 1) & mask_)
+	{
+		auto& flow{slots_[slot]};
+
+		if (flow.packets == 0)
+		{
+			// the caller accounts at least one packet right away, so the slot does not stay empty
+			flow = {key, 0, 0, UINT64_MAX, 0};
+			++size_;
+			return flow;
+		}
+
+		if (flow.key == key)
+		{
+			return flow;
+		}
+	}
+}
+
+void FlowTable::rehash(uint64_t capacity)
+{
+	spare_.assign(capacity, Flow{});
+	mask_ = capacity - 1;
+
+	for (const auto& flow : slots_)
+	{
+		if (flow.packets == 0)
+		{
+			continue;
+		}
+
+		insert(spare_, flow);
+	}
+
+	slots_.swap(spare_);
+}
+
+void FlowTable::insert(std::vector<Flow>& slots, const Flow& flow) const noexcept
+{
+	auto slot{std::hash<FiveTuple>{}(flow.key) & mask_};
+
+	while (slots[slot].packets != 0)
+	{
+		slot = (slot + 1) & mask_;
+	}
+
+	slots[slot] = flow;
+}
+} // namespace pcap
@@ -0,0 +1,166 @@
+#ifndef PCAP_FLOW_FLOW_TABLE_HPP
+#define PCAP_FLOW_FLOW_TABLE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "pcap/network_layer/five_tuple.hpp"
+
+namespace pcap
+{
+class Packet;
+class PacketBatch;
+
+/**
+ * @brief Per-flow statistics keyed on the IPv4 5-tuple, kept in an open-addressing hash table
+ * with linear probing: flows are stored inline in a single array, a lookup touches one or two cache lines.
+ * 
+ * Flows are unidirectional, packets other than Ethernet IPv4 ones are ignored.
+ */
+class FlowTable final
+{
+public:
+	struct Flow
+	{
+		FiveTuple key;
+		uint64_t packets;
+		// captured bytes
+		uint64_t bytes;
+		// `nanoseconds`
+		uint64_t firstTimestamp;
+		// `nanoseconds`
+		uint64_t lastTimestamp;
+	};
+
+	struct Options
+	{
+		// initial number of slots, rounded up to a power of two, the table grows when it is 3/4 full
+		uint64_t capacity{64 * 1024};
+		// flows without packets for this long are evicted, `nanoseconds`; zero disables eviction
+		uint64_t idleTimeout{};
+	};
+
+	FlowTable();
+	explicit FlowTable(const Options& options);
+
+	/**
+	 * @brief Accounts a packet to its flow.
+	 * 
+	 * @param key Flow 5-tuple, ignored if invalid
+	 * @param timestamp Packet timestamp `nanoseconds`
+	 * @param length Captured packet length
+	 */
+	void add(const FiveTuple& key, uint64_t timestamp, uint32_t length);
+
+	/**
+	 * @brief Accounts a packet to its flow.
+	 * 
+	 * @param packet Packet
+	 */
+	void add(const Packet& packet);
+
+	/**
+	 * @brief Accounts all batch packets to their flows, 5-tuples are extracted for the whole batch at once.
+	 * 
+	 * @param batch Packet batch
+	 */
+	void add(const PacketBatch& batch);
+
+	/**
+	 * @brief Merges flow statistics, e.g. collected by another table over other packets.
+	 * 
+	 * @param flow Flow
+	 */
+	void merge(const Flow& flow);
+
+	/**
+	 * @brief Merges all flows of another table, its evicted flows are not merged.
+	 * 
+	 * @param table Flow table
+	 */
+	void merge(const FlowTable& table);
+
+	/**
+	 * @brief Evicts the flows idle at the given time. Also done automatically while packets are added.
+	 * 
+	 * @param timestamp Current time `nanoseconds`
+	 */
+	void evict(uint64_t timestamp);
+
+	/**
+	 * @brief Moves out the flows evicted so far.
+	 * 
+	 * @param flows Evicted flows, replaced
+	 */
+	void takeEvicted(std::vector<Flow>& flows);
+
+	/**
+	 * @brief Finds a flow.
+	 * 
+	 * @param key Flow 5-tuple
+	 * 
+	 * @return Flow or `nullptr` if it is not in the table
+	 */
+	[[nodiscard]] const Flow* find(const FiveTuple& key) const noexcept;
+
+	/**
+	 * @brief Calls a function for every flow in the table.
+	 * 
+	 * @param function Function called with `const Flow&`
+	 */
+	template <typename Function>
+	void forEach(Function&& function) const;
+
+	/**
+	 * @brief Returns the number of flows in the table.
+	 * 
+	 * @return Number of flows
+	 */
+	[[nodiscard]] uint64_t size() const noexcept;
+
+	/**
+	 * @brief Returns the number of slots.
+	 * 
+	 * @return Number of slots
+	 */
+	[[nodiscard]] uint64_t capacity() const noexcept;
+
+	/**
+	 * @brief Removes all flows including the evicted ones, keeping the allocated memory.
+	 */
+	void clear() noexcept;
+
+private:
+	void update(const FiveTuple& key, uint64_t hash, uint64_t timestamp, uint32_t length);
+	Flow& emplace(const FiveTuple& key, uint64_t hash);
+	void rehash(uint64_t capacity);
+	// places a flow known not to be in the slots
+	void insert(std::vector<Flow>& slots, const Flow& flow) const noexcept;
+
+	std::vector<Flow> slots_;
+	// the next slots: flows are moved there on growth and eviction instead of being deleted in place
+	std::vector<Flow> spare_;
+	std::vector<Flow> evicted_;
+	std::vector<FiveTuple> tuples_;
+	std::vector<uint64_t> hashes_;
+	uint64_t mask_;
+	uint64_t size_;
+	uint64_t idleTimeout_;
+	uint64_t nextEviction_;
+};
+
+template <typename Function>
+void FlowTable::forEach(Function&& function) const
+{
+	for (const auto& flow : slots_)
+	{
+		// empty slots have no packets
+		if (flow.packets != 0)
+		{
+			function(flow);
+		}
+	}
+}
+} // namespace pcap
+
+#endif // PCAP_FLOW_FLOW_TABLE_HPP
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#include "packet_index.hpp"
+#include "pcap/file_reader/file_reader.hpp"
+#include "pcap/packet/packet.hpp"
+
+constexpr char indexMagicNumber[]{'P', 'C', 'I', 'X'};
+constexpr uint32_t indexVersion{1};
+
+namespace pcap
+{
+namespace
+{
+#pragma pack(push, 1)
+struct IndexHeader
+{
+	char magicNumber[4];
+	uint32_t version;
+	uint64_t interval;
+	uint64_t fileSize;
+	uint64_t entries;
+};
+#pragma pack(pop)
+} // namespace
+
+PacketIndex::PacketIndex() noexcept : interval_{defaultInterval}, fileSize_{} {}
+
+PacketIndex PacketIndex::build(const std::string& fileName, uint64_t interval)
+{
+	PacketIndex index{};
+	index.interval_ = std::max<uint64_t>(1, interval);
+
+	FileReader reader{fileName, FileReader::Options{.mode = FileReader::Mode::memoryMapped}};
+	Packet packet{};
+
+	index.fileSize_ = reader.fileSize();
+
+	// packets refer to the mapping, so reading them one by one is as cheap as reading batches,
+	// and the offset before a read is where the record starts in both PCAP and pcapng files
+	for (auto offset{reader.readBytes()}; reader.readNextPacket(packet); offset = reader.readBytes())
+	{
+		const auto packetNumber{reader.readPackets() - 1};
+
+		if (packetNumber % index.interval_ == 0)
+		{
+			index.entries_.push_back({offset, packetNumber, packet.timestamp()});
+		}
+	}
+
+	return index;
+}
+
+PacketIndex PacketIndex::load(const std::string& indexFileName)
+{
+	std::ifstream file{indexFileName, std::ios::binary};
+
+	if (not file.is_open())
+	{
+		throw std::runtime_error(std::format("pcap::PacketIndex [exception]: cannot open '{}': file does not exist.", indexFileName));
+	}
+
+	IndexHeader header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(IndexHeader));
+
+	if (file.gcount() != sizeof(IndexHeader) or std::memcmp(header.magicNumber, indexMagicNumber, sizeof(indexMagicNumber)) or
+	    header.version != indexVersion)
+	{
+		throw std::runtime_error(std::format("pcap::PacketIndex [exception]: '{}' is not a packet index.", indexFileName));
+	}
+
+	// the entry count is checked against the file before anything is allocated for it
+	file.seekg(0, std::ios::end);
+	const auto remaining{static_cast<uint64_t>(file.tellg()) - sizeof(IndexHeader)};
+	file.seekg(sizeof(IndexHeader), std::ios::beg);
+
+	if (not file or remaining % sizeof(Entry) != 0 or header.entries != remaining / sizeof(Entry))
+	{
+		throw std::runtime_error(std::format("pcap::PacketIndex [exception]: cannot read '{}': file corrupted", indexFileName));
+	}
+
+	PacketIndex index{};
+	index.interval_ = header.interval;
+	index.fileSize_ = header.fileSize;
+	index.entries_.resize(header.entries);
+
+	const auto size{static_cast<std::streamsize>(header.entries * sizeof(Entry))};
+
+	if (file.read(reinterpret_cast<char*>(index.entries_.data()), size).gcount() != size)
+	{
+		throw std::runtime_error(std::format("pcap::PacketIndex [exception]: cannot read '{}': file corrupted", indexFileName));
+	}
+
+	return index;
+}
+
+std::string PacketIndex::sidecarName(const std::string& fileName)
+{
+	return fileName + ".idx";
+}
+
+void PacketIndex::save(const std::string& indexFileName) const
+{
+	std::ofstream file{indexFileName, std::ios::binary | std::ios::trunc};
+
+	if (not file.is_open())
+	{
+		throw std::runtime_error(std::format("pcap::PacketIndex [exception]: cannot create '{}'.", indexFileName));
+	}
+
+	IndexHeader header{{}, indexVersion, interval_, fileSize_, entries_.size()};
+	std::memcpy(header.magicNumber, indexMagicNumber, sizeof(indexMagicNumber));
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(IndexHeader));
+	file.write(reinterpret_cast<const char*>(entries_.data()), static_cast<std::streamsize>(entries_.size() * sizeof(Entry)));
+
+	if (not file)
+	{
+		throw std::runtime_error(std::format("pcap::PacketIndex [exception]: cannot write '{}'.", indexFileName));
+	}
+}
+
+const PacketIndex::Entry* PacketIndex::findPacket(uint64_t packetNumber) const noexcept
+{
+	if (entries_.empty())
+	{
+		return nullptr;
+	}
+
+	auto entry{std::upper_bound(entries_.begin(), entries_.end(), packetNumber, [](uint64_t number, const Entry& entry) {
+		return number < entry.packetNumber;
+	})};
+
+	return entry == entries_.begin() ? &entries_.front() : &*std::prev(entry);
+}
+
+const PacketIndex::Entry* PacketIndex::findTime(uint64_t timestamp) const noexcept
+{
+	if (entries_.empty())
+	{
+		return nullptr;
+	}
+
+	auto entry{std::lower_bound(entries_.begin(), entries_.end(), timestamp, [](const Entry& entry, uint64_t time) {
+		return entry.timestamp < time;
+	})};
+
+	return entry == entries_.begin() ? &entries_.front() : &*std::prev(entry);
+}
+
+std::span<const PacketIndex::Entry> PacketIndex::entries() const noexcept
+{
+	return entries_;
+}
+
+uint64_t PacketIndex::fileSize() const noexcept
+{
+	return fileSize_;
+}
+} // namespace pcap
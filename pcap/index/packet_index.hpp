@@ -0,0 +1,99 @@
+#ifndef PCAP_INDEX_PACKET_INDEX_HPP
+#define PCAP_INDEX_PACKET_INDEX_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace pcap
+{
+class PacketIndex final
+{
+public:
+	struct Entry
+	{
+		uint64_t offset;
+		uint64_t packetNumber;
+		uint64_t timestamp;
+	};
+
+	static constexpr uint64_t defaultInterval{1024};
+
+	PacketIndex() noexcept;
+
+	/**
+	 * @brief Scans the file and samples every `interval`-th packet.
+	 * 
+	 * @param fileName PCAP file name
+	 * @param interval Sampling interval in packets
+	 * 
+	 * @return Packet index
+	 */
+	[[nodiscard]] static PacketIndex build(const std::string& fileName, uint64_t interval = defaultInterval);
+
+	/**
+	 * @brief Loads the index from a sidecar file.
+	 * 
+	 * @param indexFileName Sidecar file name
+	 * 
+	 * @return Packet index
+	 */
+	[[nodiscard]] static PacketIndex load(const std::string& indexFileName);
+
+	/**
+	 * @brief Returns the default sidecar file name of a PCAP file.
+	 * 
+	 * @param fileName PCAP file name
+	 * 
+	 * @return Sidecar file name
+	 */
+	[[nodiscard]] static std::string sidecarName(const std::string& fileName);
+
+	/**
+	 * @brief Saves the index to a sidecar file.
+	 * 
+	 * @param indexFileName Sidecar file name
+	 */
+	void save(const std::string& indexFileName) const;
+
+	/**
+	 * @brief Returns the nearest entry at or before a packet.
+	 * 
+	 * @param packetNumber Packet number, starting from `0`
+	 * 
+	 * @return Index entry or `nullptr` if the index is empty
+	 */
+	[[nodiscard]] const Entry* findPacket(uint64_t packetNumber) const noexcept;
+
+	/**
+	 * @brief Returns the nearest entry before a point in time, assuming packets are stored in time order.
+	 * 
+	 * @param timestamp Timestamp `nanoseconds`
+	 * 
+	 * @return Index entry or `nullptr` if the index is empty
+	 */
+	[[nodiscard]] const Entry* findTime(uint64_t timestamp) const noexcept;
+
+	/**
+	 * @brief Returns the index entries.
+	 * 
+	 * @return Index entries
+	 */
+	[[nodiscard]] std::span<const Entry> entries() const noexcept;
+
+	/**
+	 * @brief Returns the size of the indexed file.
+	 * 
+	 * @return Indexed file size
+	 */
+	[[nodiscard]] uint64_t fileSize() const noexcept;
+
+private:
+	std::vector<Entry> entries_;
+	uint64_t interval_;
+	uint64_t fileSize_;
+};
+} // namespace pcap
+
+#endif // PCAP_INDEX_PACKET_INDEX_HPP
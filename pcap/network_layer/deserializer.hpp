@@ -5,10 +5,15 @@
 #include <span>
 
 #include "network_layers.hpp"
+#include "types.hpp"
 #include "pcap/utils/byte_swapper.hpp"
 
 namespace pcap
 {
+/**
+ * @brief Decodes network layers into host byte order, each operator returns the next network layer type, `-1` if
+ * the layer is truncated or malformed, and the size of the layer in the packet, including IPv4 and TCP options.
+ */
 class Deserializer final
 {
 public:
@@ -18,22 +23,64 @@ public:
 
 		if (deserialize(ethernet, data))
 		{
-			nextNetworkType = ethernet.type;
+			nextNetworkType = static_cast<int32_t>(networkLayerTypeOfEtherType(ethernet.type));
 		}
 
 		return {nextNetworkType, sizeof(network_layer::Ethernet)};
 	}
 
+	std::pair<int32_t, int32_t> operator()(network_layer::Vlan& vlan, std::span<const uint8_t> data) const noexcept
+	{
+		auto nextNetworkType{-1};
+
+		if (deserialize(vlan, data))
+		{
+			nextNetworkType = static_cast<int32_t>(networkLayerTypeOfEtherType(vlan.type));
+		}
+
+		return {nextNetworkType, sizeof(network_layer::Vlan)};
+	}
+
 	std::pair<int32_t, int32_t> operator()(network_layer::IPv4& ipv4, std::span<const uint8_t> data) const noexcept
 	{
 		auto nextNetworkType{-1};
+		int32_t size{sizeof(network_layer::IPv4)};
 
-		if (deserialize(ipv4, data))
+		if (deserialize(ipv4, data) and ipv4.version == 4 and ipv4.headerLength * 4 >= size and ipv4.headerLength * 4U <= data.size())
 		{
-			nextNetworkType = ipv4.protocol;
+			size = ipv4.headerLength * 4;
+			// only the first fragment carries the transport header
+			nextNetworkType = static_cast<int32_t>((ipv4.flagsOffset & 0x1fff) == 0 ? networkLayerTypeOfProtocol(ipv4.protocol) : NetworkLayerType::unsupported);
+		}
+
+		return {nextNetworkType, size};
+	}
+
+	std::pair<int32_t, int32_t> operator()(network_layer::IPv6& ipv6, std::span<const uint8_t> data) const noexcept
+	{
+		auto nextNetworkType{-1};
+
+		// extension headers are not walked: a packet carrying them ends at the IPv6 layer
+		if (deserialize(ipv6, data) and ipv6.versionClassLabel >> 28 == 6)
+		{
+			nextNetworkType = static_cast<int32_t>(networkLayerTypeOfProtocol(ipv6.nextHeader));
+		}
+
+		return {nextNetworkType, sizeof(network_layer::IPv6)};
+	}
+
+	std::pair<int32_t, int32_t> operator()(network_layer::Tcp& tcp, std::span<const uint8_t> data) const noexcept
+	{
+		auto nextNetworkType{-1};
+		int32_t size{sizeof(network_layer::Tcp)};
+
+		if (deserialize(tcp, data) and tcp.dataOffset * 4 >= size and tcp.dataOffset * 4U <= data.size())
+		{
+			size = tcp.dataOffset * 4;
+			nextNetworkType = static_cast<int32_t>(NetworkLayerType::unsupported);
 		}
 
-		return {nextNetworkType, sizeof(network_layer::IPv4)};
+		return {nextNetworkType, size};
 	}
 
 	std::pair<int32_t, int32_t> operator()(network_layer::Udp& udp, std::span<const uint8_t> data) const noexcept
@@ -0,0 +1,44 @@
+#ifndef PCAP_NETWORK_LAYER_FIVE_TUPLE_HPP
+#define PCAP_NETWORK_LAYER_FIVE_TUPLE_HPP
+
+#include <cstdint>
+#include <functional>
+
+namespace pcap
+{
+/**
+ * @brief IPv4 flow key in host byte order. Ports are zero for protocols other than UDP and TCP and for non-first fragments.
+ */
+struct FiveTuple
+{
+	uint32_t sourceAddress;
+	uint32_t destinationAddress;
+	uint16_t sourcePort;
+	uint16_t destinationPort;
+	uint8_t protocol;
+	// the packet is an Ethernet IPv4 packet, otherwise the other fields are zero
+	bool valid;
+
+	[[nodiscard]] bool operator==(const FiveTuple&) const noexcept = default;
+};
+} // namespace pcap
+
+template <>
+struct std::hash<pcap::FiveTuple>
+{
+	[[nodiscard]] size_t operator()(const pcap::FiveTuple& tuple) const noexcept
+	{
+		const auto addresses{(static_cast<uint64_t>(tuple.sourceAddress) << 32) | tuple.destinationAddress};
+		const auto ports{(static_cast<uint64_t>(tuple.sourcePort) << 24) | (static_cast<uint64_t>(tuple.destinationPort) << 8) | tuple.protocol};
+
+		// MurmurHash3 finalizer: every output bit depends on every input bit, so both low bits (table slots)
+		// and high bits (shards) are usable
+		auto hash{addresses ^ (ports * 0x9e3779b97f4a7c15ull)};
+		hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdull;
+		hash = (hash ^ (hash >> 33)) * 0xc4ceb9fe1a85ec53ull;
+
+		return hash ^ (hash >> 33);
+	}
+};
+
+#endif // PCAP_NETWORK_LAYER_FIVE_TUPLE_HPP
@@ -16,6 +16,13 @@ struct Ethernet
 	uint16_t type;
 };
 
+// 802.1Q or 802.1ad tag, `type` is the type of the tagged frame
+struct Vlan
+{
+	uint16_t tagControl;
+	uint16_t type;
+};
+
 struct IPv4
 {
 #if __BYTE_ORDER == __LITTLE_ENDIAN
@@ -36,6 +43,36 @@ struct IPv4
 	uint32_t destinationAddress;
 };
 
+struct IPv6
+{
+	// version, traffic class and flow label
+	uint32_t versionClassLabel;
+	uint16_t payloadLength;
+	uint8_t nextHeader;
+	uint8_t hopLimit;
+	uint8_t sourceAddress[16];
+	uint8_t destinationAddress[16];
+};
+
+struct Tcp
+{
+	uint16_t sourcePort;
+	uint16_t destinationPort;
+	uint32_t sequenceNumber;
+	uint32_t acknowledgmentNumber;
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+	uint8_t reserved : 4;
+	uint8_t dataOffset : 4;
+#elif __BYTE_ORDER == __BIG_ENDIAN
+	uint8_t dataOffset : 4;
+	uint8_t reserved : 4;
+#endif
+	uint8_t flags;
+	uint16_t window;
+	uint16_t checksum;
+	uint16_t urgentPointer;
+};
+
 struct Udp
 {
 	uint16_t sourcePort;
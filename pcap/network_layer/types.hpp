@@ -7,15 +7,106 @@
 
 namespace pcap
 {
+/**
+ * @brief Network layers decoded by the library, `unsupported` ends a chain of layers: the rest of the packet is payload.
+ */
 enum class NetworkLayerType : uint16_t
 {
-	unsupported = 0x00,
-	ethernet = 0x01,
-	ip_v4 = 0x08,
-	udp = 0x11
+	unsupported,
+	ethernet,
+	vlan,
+	ip_v4,
+	ip_v6,
+	tcp,
+	udp
 };
 
-using NetworkLayer_t = std::variant<network_layer::Ethernet, network_layer::IPv4, network_layer::Udp>;
+using NetworkLayer_t = std::variant<network_layer::Ethernet,
+				    network_layer::Vlan,
+				    network_layer::IPv4,
+				    network_layer::IPv6,
+				    network_layer::Tcp,
+				    network_layer::Udp>;
+
+/**
+ * @brief Returns the first network layer of a packet with a link layer type.
+ * 
+ * @param linkLayerType Link layer type of the capture
+ * 
+ * @return Network layer type
+ */
+[[nodiscard]] constexpr NetworkLayerType networkLayerTypeOfLinkLayer(uint32_t linkLayerType) noexcept
+{
+	return linkLayerType == 1 ? NetworkLayerType::ethernet : NetworkLayerType::unsupported;
+}
+
+/**
+ * @brief Returns the network layer carried by an Ethernet frame or a VLAN tag.
+ * 
+ * @param etherType Ethertype in host byte order
+ * 
+ * @return Network layer type
+ */
+[[nodiscard]] constexpr NetworkLayerType networkLayerTypeOfEtherType(uint16_t etherType) noexcept
+{
+	switch (etherType)
+	{
+	case 0x0800:
+		return NetworkLayerType::ip_v4;
+	case 0x86dd:
+		return NetworkLayerType::ip_v6;
+	// 802.1Q and 802.1ad (QinQ)
+	case 0x8100:
+	case 0x88a8:
+		return NetworkLayerType::vlan;
+	default:
+		return NetworkLayerType::unsupported;
+	}
+}
+
+/**
+ * @brief Returns the network layer carried by an IPv4 or IPv6 packet.
+ * 
+ * @param protocol IP protocol number
+ * 
+ * @return Network layer type
+ */
+[[nodiscard]] constexpr NetworkLayerType networkLayerTypeOfProtocol(uint8_t protocol) noexcept
+{
+	switch (protocol)
+	{
+	case 6:
+		return NetworkLayerType::tcp;
+	case 17:
+		return NetworkLayerType::udp;
+	default:
+		return NetworkLayerType::unsupported;
+	}
+}
+
+/**
+ * @brief Network layer type of a network layer structure, known at compile time.
+ */
+template <typename Layer>
+inline constexpr NetworkLayerType networkLayerType{NetworkLayerType::unsupported};
+
+template <>
+inline constexpr NetworkLayerType networkLayerType<network_layer::Ethernet>{NetworkLayerType::ethernet};
+
+template <>
+inline constexpr NetworkLayerType networkLayerType<network_layer::Vlan>{NetworkLayerType::vlan};
+
+template <>
+inline constexpr NetworkLayerType networkLayerType<network_layer::IPv4>{NetworkLayerType::ip_v4};
+
+template <>
+inline constexpr NetworkLayerType networkLayerType<network_layer::IPv6>{NetworkLayerType::ip_v6};
+
+template <>
+inline constexpr NetworkLayerType networkLayerType<network_layer::Tcp>{NetworkLayerType::tcp};
+
+template <>
+inline constexpr NetworkLayerType networkLayerType<network_layer::Udp>{NetworkLayerType::udp};
 } // namespace pcap
 
 #endif // PCAP_NETWORK_LAYER_TYPES_HPP
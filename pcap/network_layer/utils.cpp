@@ -9,8 +9,14 @@ std::optional<NetworkLayer_t> getNetworkLayer(uint16_t type) noexcept
 	{
 	case NetworkLayerType::ethernet:
 		return network_layer::Ethernet{};
+	case NetworkLayerType::vlan:
+		return network_layer::Vlan{};
 	case NetworkLayerType::ip_v4:
 		return network_layer::IPv4{};
+	case NetworkLayerType::ip_v6:
+		return network_layer::IPv6{};
+	case NetworkLayerType::tcp:
+		return network_layer::Tcp{};
 	case NetworkLayerType::udp:
 		return network_layer::Udp{};
 	default:
@@ -0,0 +1,424 @@
+#ifndef PCAP_NETWORK_LAYER_VIEWS_HPP
+#define PCAP_NETWORK_LAYER_VIEWS_HPP
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "types.hpp"
+
+namespace pcap
+{
+namespace network_layer
+{
+/**
+ * @brief Reads a network byte order field in place and converts it to host byte order.
+ * 
+ * @param data Layer data
+ * @param offset Field offset
+ * 
+ * @return Field value
+ */
+template <typename T>
+[[nodiscard]] T load(std::span<const uint8_t> data, uint64_t offset) noexcept
+{
+	T value{};
+	std::memcpy(&value, data.data() + offset, sizeof(T));
+
+	if constexpr (std::endian::native == std::endian::little and sizeof(T) > 1)
+	{
+		value = std::byteswap(value);
+	}
+
+	return value;
+}
+
+/**
+ * @brief Ethernet header view: fields are read from the packet bytes on access.
+ */
+class EthernetView final
+{
+public:
+	static constexpr NetworkLayerType type{NetworkLayerType::ethernet};
+	static constexpr uint16_t etherTypeIPv4{0x0800};
+	static constexpr uint16_t etherTypeIPv6{0x86dd};
+	static constexpr uint16_t etherTypeVlan{0x8100};
+	static constexpr uint16_t etherTypeQinQ{0x88a8};
+
+	explicit EthernetView(std::span<const uint8_t> data) noexcept : data_{data} {}
+
+	[[nodiscard]] static bool valid(std::span<const uint8_t> data) noexcept
+	{
+		return data.size() >= sizeof(Ethernet);
+	}
+
+	[[nodiscard]] std::span<const uint8_t, 6> destination() const noexcept
+	{
+		return data_.subspan<0, 6>();
+	}
+
+	[[nodiscard]] std::span<const uint8_t, 6> source() const noexcept
+	{
+		return data_.subspan<6, 6>();
+	}
+
+	[[nodiscard]] uint16_t etherType() const noexcept
+	{
+		return load<uint16_t>(data_, 12);
+	}
+
+	[[nodiscard]] uint64_t headerLength() const noexcept
+	{
+		return sizeof(Ethernet);
+	}
+
+	[[nodiscard]] NetworkLayerType nextLayerType() const noexcept
+	{
+		return networkLayerTypeOfEtherType(etherType());
+	}
+
+private:
+	std::span<const uint8_t> data_;
+};
+
+/**
+ * @brief 802.1Q or 802.1ad tag view: fields are read from the packet bytes on access, stacked tags are separate layers.
+ */
+class VlanView final
+{
+public:
+	static constexpr NetworkLayerType type{NetworkLayerType::vlan};
+
+	explicit VlanView(std::span<const uint8_t> data) noexcept : data_{data} {}
+
+	[[nodiscard]] static bool valid(std::span<const uint8_t> data) noexcept
+	{
+		return data.size() >= sizeof(Vlan);
+	}
+
+	[[nodiscard]] uint8_t priority() const noexcept
+	{
+		return data_[0] >> 5;
+	}
+
+	[[nodiscard]] bool dropEligible() const noexcept
+	{
+		return (data_[0] & 0x10) != 0;
+	}
+
+	[[nodiscard]] uint16_t identifier() const noexcept
+	{
+		return load<uint16_t>(data_, 0) & 0x0fff;
+	}
+
+	[[nodiscard]] uint16_t etherType() const noexcept
+	{
+		return load<uint16_t>(data_, 2);
+	}
+
+	[[nodiscard]] uint64_t headerLength() const noexcept
+	{
+		return sizeof(Vlan);
+	}
+
+	[[nodiscard]] NetworkLayerType nextLayerType() const noexcept
+	{
+		return networkLayerTypeOfEtherType(etherType());
+	}
+
+private:
+	std::span<const uint8_t> data_;
+};
+
+/**
+ * @brief IPv4 header view: fields are read from the packet bytes on access, options are accounted for.
+ */
+class IPv4View final
+{
+public:
+	static constexpr NetworkLayerType type{NetworkLayerType::ip_v4};
+	static constexpr uint8_t protocolTcp{6};
+	static constexpr uint8_t protocolUdp{17};
+
+	explicit IPv4View(std::span<const uint8_t> data) noexcept : data_{data} {}
+
+	[[nodiscard]] static bool valid(std::span<const uint8_t> data) noexcept
+	{
+		if (data.size() < sizeof(IPv4))
+		{
+			return false;
+		}
+
+		const IPv4View view{data};
+
+		return view.version() == 4 and view.headerLength() >= sizeof(IPv4) and view.headerLength() <= data.size();
+	}
+
+	[[nodiscard]] uint8_t version() const noexcept
+	{
+		return data_[0] >> 4;
+	}
+
+	[[nodiscard]] uint64_t headerLength() const noexcept
+	{
+		return static_cast<uint64_t>(data_[0] & 0x0f) * 4;
+	}
+
+	[[nodiscard]] uint8_t serviceType() const noexcept
+	{
+		return data_[1];
+	}
+
+	[[nodiscard]] uint16_t totalLength() const noexcept
+	{
+		return load<uint16_t>(data_, 2);
+	}
+
+	[[nodiscard]] uint16_t identification() const noexcept
+	{
+		return load<uint16_t>(data_, 4);
+	}
+
+	[[nodiscard]] uint8_t flags() const noexcept
+	{
+		return data_[6] >> 5;
+	}
+
+	[[nodiscard]] uint16_t fragmentOffset() const noexcept
+	{
+		return load<uint16_t>(data_, 6) & 0x1fff;
+	}
+
+	[[nodiscard]] uint8_t timeToLive() const noexcept
+	{
+		return data_[8];
+	}
+
+	[[nodiscard]] uint8_t protocol() const noexcept
+	{
+		return data_[9];
+	}
+
+	[[nodiscard]] uint16_t checksum() const noexcept
+	{
+		return load<uint16_t>(data_, 10);
+	}
+
+	[[nodiscard]] uint32_t sourceAddress() const noexcept
+	{
+		return load<uint32_t>(data_, 12);
+	}
+
+	[[nodiscard]] uint32_t destinationAddress() const noexcept
+	{
+		return load<uint32_t>(data_, 16);
+	}
+
+	[[nodiscard]] NetworkLayerType nextLayerType() const noexcept
+	{
+		// only the first fragment carries the transport header
+		return fragmentOffset() == 0 ? networkLayerTypeOfProtocol(protocol()) : NetworkLayerType::unsupported;
+	}
+
+private:
+	std::span<const uint8_t> data_;
+};
+
+/**
+ * @brief IPv6 header view: fields are read from the packet bytes on access, extension headers are not walked.
+ */
+class IPv6View final
+{
+public:
+	static constexpr NetworkLayerType type{NetworkLayerType::ip_v6};
+
+	explicit IPv6View(std::span<const uint8_t> data) noexcept : data_{data} {}
+
+	[[nodiscard]] static bool valid(std::span<const uint8_t> data) noexcept
+	{
+		return data.size() >= sizeof(IPv6) and IPv6View{data}.version() == 6;
+	}
+
+	[[nodiscard]] uint8_t version() const noexcept
+	{
+		return data_[0] >> 4;
+	}
+
+	[[nodiscard]] uint8_t trafficClass() const noexcept
+	{
+		return static_cast<uint8_t>(load<uint16_t>(data_, 0) >> 4);
+	}
+
+	[[nodiscard]] uint32_t flowLabel() const noexcept
+	{
+		return load<uint32_t>(data_, 0) & 0x000fffff;
+	}
+
+	[[nodiscard]] uint16_t payloadLength() const noexcept
+	{
+		return load<uint16_t>(data_, 4);
+	}
+
+	[[nodiscard]] uint8_t nextHeader() const noexcept
+	{
+		return data_[6];
+	}
+
+	[[nodiscard]] uint8_t hopLimit() const noexcept
+	{
+		return data_[7];
+	}
+
+	[[nodiscard]] std::span<const uint8_t, 16> sourceAddress() const noexcept
+	{
+		return data_.subspan<8, 16>();
+	}
+
+	[[nodiscard]] std::span<const uint8_t, 16> destinationAddress() const noexcept
+	{
+		return data_.subspan<24, 16>();
+	}
+
+	[[nodiscard]] uint64_t headerLength() const noexcept
+	{
+		return sizeof(IPv6);
+	}
+
+	[[nodiscard]] NetworkLayerType nextLayerType() const noexcept
+	{
+		return networkLayerTypeOfProtocol(nextHeader());
+	}
+
+private:
+	std::span<const uint8_t> data_;
+};
+
+/**
+ * @brief TCP header view: fields are read from the packet bytes on access, options are accounted for.
+ */
+class TcpView final
+{
+public:
+	static constexpr NetworkLayerType type{NetworkLayerType::tcp};
+
+	explicit TcpView(std::span<const uint8_t> data) noexcept : data_{data} {}
+
+	[[nodiscard]] static bool valid(std::span<const uint8_t> data) noexcept
+	{
+		if (data.size() < sizeof(Tcp))
+		{
+			return false;
+		}
+
+		const TcpView view{data};
+
+		return view.headerLength() >= sizeof(Tcp) and view.headerLength() <= data.size();
+	}
+
+	[[nodiscard]] uint16_t sourcePort() const noexcept
+	{
+		return load<uint16_t>(data_, 0);
+	}
+
+	[[nodiscard]] uint16_t destinationPort() const noexcept
+	{
+		return load<uint16_t>(data_, 2);
+	}
+
+	[[nodiscard]] uint32_t sequenceNumber() const noexcept
+	{
+		return load<uint32_t>(data_, 4);
+	}
+
+	[[nodiscard]] uint32_t acknowledgmentNumber() const noexcept
+	{
+		return load<uint32_t>(data_, 8);
+	}
+
+	[[nodiscard]] uint8_t flags() const noexcept
+	{
+		return data_[13];
+	}
+
+	[[nodiscard]] uint16_t window() const noexcept
+	{
+		return load<uint16_t>(data_, 14);
+	}
+
+	[[nodiscard]] uint16_t checksum() const noexcept
+	{
+		return load<uint16_t>(data_, 16);
+	}
+
+	[[nodiscard]] uint16_t urgentPointer() const noexcept
+	{
+		return load<uint16_t>(data_, 18);
+	}
+
+	[[nodiscard]] uint64_t headerLength() const noexcept
+	{
+		return static_cast<uint64_t>(data_[12] >> 4) * 4;
+	}
+
+	[[nodiscard]] NetworkLayerType nextLayerType() const noexcept
+	{
+		return NetworkLayerType::unsupported;
+	}
+
+private:
+	std::span<const uint8_t> data_;
+};
+
+/**
+ * @brief UDP header view: fields are read from the packet bytes on access.
+ */
+class UdpView final
+{
+public:
+	static constexpr NetworkLayerType type{NetworkLayerType::udp};
+
+	explicit UdpView(std::span<const uint8_t> data) noexcept : data_{data} {}
+
+	[[nodiscard]] static bool valid(std::span<const uint8_t> data) noexcept
+	{
+		return data.size() >= sizeof(Udp);
+	}
+
+	[[nodiscard]] uint16_t sourcePort() const noexcept
+	{
+		return load<uint16_t>(data_, 0);
+	}
+
+	[[nodiscard]] uint16_t destinationPort() const noexcept
+	{
+		return load<uint16_t>(data_, 2);
+	}
+
+	[[nodiscard]] uint16_t length() const noexcept
+	{
+		return load<uint16_t>(data_, 4);
+	}
+
+	[[nodiscard]] uint16_t checksum() const noexcept
+	{
+		return load<uint16_t>(data_, 6);
+	}
+
+	[[nodiscard]] uint64_t headerLength() const noexcept
+	{
+		return sizeof(Udp);
+	}
+
+	[[nodiscard]] NetworkLayerType nextLayerType() const noexcept
+	{
+		return NetworkLayerType::unsupported;
+	}
+
+private:
+	std::span<const uint8_t> data_;
+};
+} // namespace network_layer
+} // namespace pcap
+
+#endif // PCAP_NETWORK_LAYER_VIEWS_HPP
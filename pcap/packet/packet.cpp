@@ -1,20 +1,66 @@
 #include <cstring>
-#include <format>
-#include <iostream>
+#include <functional>
+#include <type_traits>
+#include <variant>
 
 #include "packet.hpp"
 #include "pcap/network_layer/utils.hpp"
+#include "pcap/utils/log.hpp"
+#include "pcap/utils/metrics.hpp"
 
 namespace pcap
 {
-Packet::Packet() noexcept : linkLayerType_{} {}
+namespace
+{
+#ifdef PCAP_WITH_METRICS
+// records the ethertype or IP protocol a chain of layers ends at, if the library does not decode it
+void recordUndecodedLayer(const NetworkLayer_t& layer) noexcept
+{
+	const auto type{std::visit(
+		[](const auto& last) -> int32_t
+		{
+			using Layer = std::decay_t<decltype(last)>;
+
+			if constexpr (std::is_same_v<Layer, network_layer::Ethernet> or std::is_same_v<Layer, network_layer::Vlan>)
+			{
+				return last.type;
+			}
+			else if constexpr (std::is_same_v<Layer, network_layer::IPv4>)
+			{
+				// non-first fragments carry no transport header to decode
+				return (last.flagsOffset & 0x1fff) == 0 ? last.protocol : -1;
+			}
+			else if constexpr (std::is_same_v<Layer, network_layer::IPv6>)
+			{
+				return last.nextHeader;
+			}
+			else
+			{
+				return -1;
+			}
+		},
+		layer)};
+
+	if (type != -1)
+	{
+		Metrics::recordUnsupportedLayer(type);
+	}
+}
+#endif
+} // namespace
+
+Packet::Packet() noexcept : layerOffsets_{}, locatedLayers_{}, linkLayerType_{} {}
 
-Packet::Packet(Packet&& packet) noexcept : linkLayerType_{}
+Packet::Packet(Packet&& packet) noexcept : layerOffsets_{}, locatedLayers_{}, linkLayerType_{}
 {
 	std::swap(buffer_, packet.buffer_);
+	std::swap(storage_, packet.storage_);
 	std::swap(layers_, packet.layers_);
 	std::swap(timestamp_, packet.timestamp_);
+	std::swap(data_, packet.data_);
 	std::swap(payload_, packet.payload_);
+	std::swap(layerOffsets_, packet.layerOffsets_);
+	std::swap(locatedLayers_, packet.locatedLayers_);
 	std::swap(linkLayerType_, packet.linkLayerType_);
 }
 
@@ -23,9 +69,14 @@ Packet& Packet::operator=(Packet&& packet) noexcept
 	if (this != &packet)
 	{
 		buffer_ = std::move(packet.buffer_);
+		storage_ = std::move(packet.storage_);
 		layers_ = std::move(packet.layers_);
 		timestamp_ = std::move(packet.timestamp_);
+		data_ = std::move(packet.data_);
 		payload_ = std::move(packet.payload_);
+		layerOffsets_ = packet.layerOffsets_;
+		locatedLayers_ = packet.locatedLayers_;
+		packet.locatedLayers_ = 0;
 
 		linkLayerType_ = packet.linkLayerType_;
 		packet.linkLayerType_ = 0;
@@ -37,15 +88,27 @@ Packet& Packet::operator=(Packet&& packet) noexcept
 void Packet::fill(const std::chrono::nanoseconds& timestamp, uint32_t linkLayerType, const byte_buffer::ByteBuffer& buffer)
 {
 	timestamp_ = timestamp;
+	locatedLayers_ = 0;
 	linkLayerType_ = linkLayerType;
 	buffer_ = buffer;
+	data_ = buffer_.data();
 }
 
 void Packet::fill(const std::chrono::nanoseconds& timestamp, uint32_t linkLayerType, byte_buffer::ByteBuffer&& buffer)
 {
 	timestamp_ = timestamp;
+	locatedLayers_ = 0;
 	linkLayerType_ = linkLayerType;
 	buffer_ = std::move(buffer);
+	data_ = buffer_.data();
+}
+
+void Packet::fill(const std::chrono::nanoseconds& timestamp, uint32_t linkLayerType, std::span<const uint8_t> data) noexcept
+{
+	timestamp_ = timestamp;
+	locatedLayers_ = 0;
+	linkLayerType_ = linkLayerType;
+	data_ = data;
 }
 
 uint64_t Packet::timestamp() const noexcept
@@ -55,36 +118,103 @@ uint64_t Packet::timestamp() const noexcept
 
 uint16_t Packet::size() const noexcept
 {
-	return buffer_.size();
+	return data_.size();
+}
+
+uint32_t Packet::linkLayerType() const noexcept
+{
+	return linkLayerType_;
+}
+
+std::span<const uint8_t> Packet::data() const noexcept
+{
+	return data_;
 }
 
 bool Packet::parse() noexcept
 {
 	layers_.clear();
-	payload_ = buffer_.data();
+	payload_ = data_;
 
-	auto networkLayerType{static_cast<int32_t>(linkLayerType_)};
+	auto networkLayerType{static_cast<int32_t>(networkLayerTypeOfLinkLayer(linkLayerType_))};
+
+	if (networkLayerType == static_cast<int32_t>(NetworkLayerType::unsupported))
+	{
+		PCAP_METRICS(Metrics::recordParseFailure(Metrics::ParseFailure::unsupportedLayer));
+		PCAP_METRICS(Metrics::recordUnsupportedLayer(linkLayerType_));
+		PCAP_LOG(LogLevel::debug, "pcap::Packet: unsupported link layer {}", linkLayerType_);
+		return false;
+	}
 
 	do
 	{
 		auto layer{getNetworkLayer(networkLayerType)};
 
-		if (not layer)
+		networkLayerType = deserializeNetworkLayer(*layer, payload_, true);
+
+		if (networkLayerType == -1)
 		{
-			std::cerr << std::format("pcap::Packet: unsupported network layer {}\n", networkLayerType);
+			PCAP_METRICS(Metrics::recordParseFailure(Metrics::ParseFailure::truncatedLayer));
+			PCAP_LOG(LogLevel::debug, "pcap::Packet: cannot deserialize network layer: packet truncated or malformed");
 			return false;
 		}
 
-		networkLayerType = deserializeNetworkLayer(*layer, payload_, true);
+		layers_.push_back(*layer);
+	} while (networkLayerType != static_cast<int32_t>(NetworkLayerType::unsupported));
 
-		if (networkLayerType == -1)
+	PCAP_METRICS(recordUndecodedLayer(layers_.back()));
+
+	return true;
+}
+
+bool Packet::locate() noexcept
+{
+	locatedLayers_ = 0;
+	payload_ = data_;
+
+	uint64_t offset{};
+	auto networkLayerType{networkLayerTypeOfLinkLayer(linkLayerType_)};
+
+	if (networkLayerType == NetworkLayerType::unsupported)
+	{
+		return false;
+	}
+
+	while (networkLayerType != NetworkLayerType::unsupported)
+	{
+		auto located{false};
+
+		switch (networkLayerType)
+		{
+		case NetworkLayerType::ethernet:
+			located = locateLayer<network_layer::EthernetView>(offset, networkLayerType);
+			break;
+		case NetworkLayerType::vlan:
+			located = locateLayer<network_layer::VlanView>(offset, networkLayerType);
+			break;
+		case NetworkLayerType::ip_v4:
+			located = locateLayer<network_layer::IPv4View>(offset, networkLayerType);
+			break;
+		case NetworkLayerType::ip_v6:
+			located = locateLayer<network_layer::IPv6View>(offset, networkLayerType);
+			break;
+		case NetworkLayerType::tcp:
+			located = locateLayer<network_layer::TcpView>(offset, networkLayerType);
+			break;
+		case NetworkLayerType::udp:
+			located = locateLayer<network_layer::UdpView>(offset, networkLayerType);
+			break;
+		default:
+			break;
+		}
+
+		if (not located)
 		{
-			std::cerr << "pcap::Packet: cannot deserialize network layer: file corrupted\n";
 			return false;
 		}
+	}
 
-		layers_.push_back(*layer);
-	} while (networkLayerType != static_cast<uint16_t>(NetworkLayerType::unsupported));
+	payload_ = data_.subspan(offset);
 
 	return true;
 }
@@ -99,11 +229,29 @@ const NetworkLayer_t* Packet::lastLayer() const noexcept
 	return layers_.empty() ? nullptr : &layers_.back();
 }
 
-const std::vector<NetworkLayer_t>& Packet::layers() const noexcept
+const Packet::Layers& Packet::layers() const noexcept
 {
 	return layers_;
 }
 
+void Packet::own()
+{
+	if (data_.data() == storage_.data())
+	{
+		return;
+	}
+
+	// the payload keeps its position if it belongs to this packet, the located layers are stored as offsets already
+	const auto* begin{data_.data()};
+	const auto* payload{payload_.data()};
+	const auto ownPayload{std::less_equal{}(begin, payload) and std::less_equal{}(payload + payload_.size(), begin + data_.size())};
+	const auto payloadOffset{ownPayload ? static_cast<uint64_t>(payload - begin) : data_.size()};
+
+	storage_.assign(data_.begin(), data_.end());
+	data_ = storage_;
+	payload_ = data_.subspan(payloadOffset, ownPayload ? payload_.size() : 0);
+}
+
 std::span<const uint8_t> Packet::payload() const noexcept
 {
 	return payload_;
@@ -1,18 +1,28 @@
 #ifndef PCAP_PACKET_HPP
 #define PCAP_PACKET_HPP
 
+#include <array>
 #include <chrono>
 #include <cstdint>
+#include <optional>
+#include <span>
+#include <tuple>
 #include <vector>
 
 #include "byte_buffer/byte_buffer.hpp"
+#include "pcap/network_layer/deserializer.hpp"
 #include "pcap/network_layer/types.hpp"
+#include "pcap/network_layer/views.hpp"
+#include "pcap/utils/small_vector.hpp"
 
 namespace pcap
 {
 class Packet final
 {
 public:
+	// typical packets have a handful of layers, they are kept inline
+	using Layers = SmallVector<NetworkLayer_t, 8>;
+
 	Packet() noexcept;
 	Packet(const Packet&) = delete;
 	Packet(Packet&&) noexcept;
@@ -41,6 +51,15 @@ public:
 	 */
 	void fill(const std::chrono::nanoseconds& timestamp, uint32_t linkLayerType, byte_buffer::ByteBuffer&& buffer);
 
+	/**
+	 * @brief Fills out the packet without copying: the packet refers to the data, which must outlive it.
+	 * 
+	 * @param timestamp Timestamp `nanoseconds`
+	 * @param linkLayerType Link layer type
+	 * @param data Packet data
+	 */
+	void fill(const std::chrono::nanoseconds& timestamp, uint32_t linkLayerType, std::span<const uint8_t> data) noexcept;
+
 	/**
 	 * @brief Returns the packet timestamp.
 	 * 
@@ -55,6 +74,20 @@ public:
 	 */
 	[[nodiscard]] uint16_t size() const noexcept;
 
+	/**
+	 * @brief Returns the packet link layer type.
+	 * 
+	 * @return Link layer type
+	 */
+	[[nodiscard]] uint32_t linkLayerType() const noexcept;
+
+	/**
+	 * @brief Returns the packet data.
+	 * 
+	 * @return Packet data
+	 */
+	[[nodiscard]] std::span<const uint8_t> data() const noexcept;
+
 	/**
 	 * @brief Parses packet network layers.
 	 * 
@@ -62,6 +95,33 @@ public:
 	 */
 	[[nodiscard]] bool parse() noexcept;
 
+	/**
+	 * @brief Parses an expected chain of network layers resolved at compile time, e.g. `parse<Ethernet, IPv4, Udp>()`.
+	 * 
+	 * The layers are decoded into a tuple on the stack, without variants or allocations, and `payload()` follows
+	 * the last of them. If the packet does not start with the chain, it falls back to `parse()` and `layers()`.
+	 * 
+	 * @return Network layers if the packet matches the chain, otherwise - `std::nullopt`
+	 */
+	template <typename... Layers>
+	[[nodiscard]] std::optional<std::tuple<Layers...>> parse() noexcept;
+
+	/**
+	 * @brief Locates packet network layers without decoding them: only layer offsets are computed,
+	 * fields are read on access through `layer()` views.
+	 * 
+	 * @return `True` if the network layers of the packet were located, otherwise - `false`
+	 */
+	[[nodiscard]] bool locate() noexcept;
+
+	/**
+	 * @brief Returns a view of a network layer located by `locate()`, e.g. `layer<network_layer::UdpView>()`.
+	 * 
+	 * @return Network layer view if the packet has the layer, otherwise - `std::nullopt`
+	 */
+	template <typename View>
+	[[nodiscard]] std::optional<View> layer() const noexcept;
+
 	/**
 	 * @brief Returns the first network layer of a packet.
 	 * 
@@ -81,7 +141,13 @@ public:
 	 * 
 	 * @return Packet network layers
 	 */
-	[[nodiscard]] const std::vector<NetworkLayer_t>& layers() const noexcept;
+	[[nodiscard]] const Layers& layers() const noexcept;
+
+	/**
+	 * @brief Copies the packet bytes into storage owned by the packet, so the packet stays valid after
+	 * the reader or batch it refers to moves on. The storage is reused, it only grows for larger packets.
+	 */
+	void own();
 
 	/**
 	 * @brief Returns the packet payload.
@@ -91,12 +157,109 @@ public:
 	[[nodiscard]] std::span<const uint8_t> payload() const noexcept;
 
 private:
+	struct LayerOffset
+	{
+		NetworkLayerType type;
+		uint16_t offset;
+	};
+
+	static constexpr uint64_t maxLocatedLayers{8};
+
+	template <typename Layer>
+	static bool parseLayer(Layer& layer, std::span<const uint8_t>& data, int32_t& networkLayerType) noexcept;
+
+	template <typename View>
+	bool locateLayer(uint64_t& offset, NetworkLayerType& networkLayerType) noexcept;
+
 	byte_buffer::ByteBuffer buffer_;
-	std::vector<NetworkLayer_t> layers_;
+	// owned copy of the packet bytes made by `own()`
+	std::vector<uint8_t> storage_;
+	Layers layers_;
 	std::chrono::nanoseconds timestamp_;
+	std::span<const uint8_t> data_;
 	std::span<const uint8_t> payload_;
+	std::array<LayerOffset, maxLocatedLayers> layerOffsets_;
+	uint8_t locatedLayers_;
 	uint32_t linkLayerType_;
 };
+
+template <typename... Layers>
+std::optional<std::tuple<Layers...>> Packet::parse() noexcept
+{
+	static_assert(sizeof...(Layers) > 0, "pcap::Packet: at least one network layer is expected");
+
+	std::tuple<Layers...> layers{};
+	auto payload{data_};
+	auto networkLayerType{static_cast<int32_t>(networkLayerTypeOfLinkLayer(linkLayerType_))};
+
+	// the fold stops at the first layer that does not match
+	const auto matched{std::apply([&](auto&... layer) { return (parseLayer(layer, payload, networkLayerType) and ...); }, layers)};
+
+	if (not matched)
+	{
+		static_cast<void>(parse());
+		return std::nullopt;
+	}
+
+	layers_.clear();
+	payload_ = payload;
+
+	return layers;
+}
+
+template <typename Layer>
+bool Packet::parseLayer(Layer& layer, std::span<const uint8_t>& data, int32_t& networkLayerType) noexcept
+{
+	if (networkLayerType != static_cast<int32_t>(pcap::networkLayerType<Layer>))
+	{
+		return false;
+	}
+
+	const auto [nextNetworkLayerType, networkLayerSize]{Deserializer{}(layer, data)};
+
+	if (nextNetworkLayerType == -1)
+	{
+		return false;
+	}
+
+	data = data.subspan(networkLayerSize);
+	networkLayerType = nextNetworkLayerType;
+
+	return true;
+}
+
+template <typename View>
+std::optional<View> Packet::layer() const noexcept
+{
+	for (uint8_t i{}; i < locatedLayers_; ++i)
+	{
+		if (layerOffsets_[i].type == View::type)
+		{
+			return View{data_.subspan(layerOffsets_[i].offset)};
+		}
+	}
+
+	return std::nullopt;
+}
+
+template <typename View>
+bool Packet::locateLayer(uint64_t& offset, NetworkLayerType& networkLayerType) noexcept
+{
+	const auto data{data_.subspan(offset)};
+
+	if (not View::valid(data) or locatedLayers_ == maxLocatedLayers)
+	{
+		return false;
+	}
+
+	const View view{data};
+
+	layerOffsets_[locatedLayers_++] = {View::type, static_cast<uint16_t>(offset)};
+	offset += view.headerLength();
+	networkLayerType = view.nextLayerType();
+
+	return true;
+}
 } // namespace pcap
 
 #endif
@@ -0,0 +1,115 @@
+#include "packet_batch.hpp"
+#include "packet.hpp"
+#include "pcap/utils/batch_decoder.hpp"
+
+namespace pcap
+{
+PacketBatch::PacketBatch(uint64_t arenaSize)
+	: arena_{}
+	, arenaSize_{}
+	, data_{}
+	, records_{}
+	, recordEndian_{std::endian::native}
+	, recordNanoseconds_{}
+{
+	reserveArena(arenaSize);
+}
+
+uint64_t PacketBatch::size() const noexcept
+{
+	return timestamps_.size();
+}
+
+bool PacketBatch::empty() const noexcept
+{
+	return timestamps_.empty();
+}
+
+std::span<const uint32_t> PacketBatch::linkLayerTypes() const noexcept
+{
+	return linkLayerTypes_;
+}
+
+std::span<const uint64_t> PacketBatch::timestamps() const noexcept
+{
+	return timestamps_;
+}
+
+std::span<const uint32_t> PacketBatch::offsets() const noexcept
+{
+	return offsets_;
+}
+
+std::span<const uint32_t> PacketBatch::lengths() const noexcept
+{
+	return lengths_;
+}
+
+std::span<const uint32_t> PacketBatch::originalLengths() const noexcept
+{
+	return originalLengths_;
+}
+
+std::span<const uint8_t> PacketBatch::data() const noexcept
+{
+	return data_;
+}
+
+std::span<const uint8_t> PacketBatch::data(uint64_t index) const noexcept
+{
+	return data_.subspan(offsets_[index], lengths_[index]);
+}
+
+void PacketBatch::packet(uint64_t index, Packet& packet) const noexcept
+{
+	packet.fill(std::chrono::nanoseconds{timestamps_[index]}, linkLayerTypes_[index], data(index));
+}
+
+void PacketBatch::fiveTuples(std::vector<FiveTuple>& tuples) const
+{
+	tuples.resize(size());
+	extractFiveTuples(data_, offsets_, lengths_, linkLayerTypes_, tuples);
+}
+
+bool PacketBatch::holdsRecords(std::endian endian, bool nanoseconds) const noexcept
+{
+	return records_ and recordEndian_ == endian and recordNanoseconds_ == nanoseconds;
+}
+
+void PacketBatch::clear() noexcept
+{
+	data_ = {};
+	records_ = false;
+	timestamps_.clear();
+	offsets_.clear();
+	lengths_.clear();
+	originalLengths_.clear();
+	linkLayerTypes_.clear();
+}
+
+void PacketBatch::reserveArena(uint64_t size)
+{
+	if (size > arenaSize_)
+	{
+		arena_ = std::make_unique_for_overwrite<uint8_t[]>(size);
+		arenaSize_ = size;
+	}
+}
+
+void PacketBatch::push(uint64_t timestamp, uint32_t offset, uint32_t length, uint32_t originalLength, uint32_t linkLayerType)
+{
+	timestamps_.push_back(timestamp);
+	offsets_.push_back(offset);
+	lengths_.push_back(length);
+	originalLengths_.push_back(originalLength);
+	linkLayerTypes_.push_back(linkLayerType);
+}
+
+void PacketBatch::decodeHeaders(std::endian endian, bool nanoseconds) noexcept
+{
+	records_ = true;
+	recordEndian_ = endian;
+	recordNanoseconds_ = nanoseconds;
+	decodePacketHeaders(data_, offsets_, endian, nanoseconds, timestamps_, lengths_, originalLengths_);
+}
+} // namespace pcap
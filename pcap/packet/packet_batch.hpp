@@ -0,0 +1,146 @@
+#ifndef PCAP_PACKET_BATCH_HPP
+#define PCAP_PACKET_BATCH_HPP
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "pcap/network_layer/five_tuple.hpp"
+
+namespace pcap
+{
+class FileReader;
+class Packet;
+
+class PacketBatch final
+{
+public:
+	static constexpr uint64_t defaultArenaSize{4 * 1024 * 1024};
+
+	explicit PacketBatch(uint64_t arenaSize = defaultArenaSize);
+	PacketBatch(const PacketBatch&) = delete;
+	PacketBatch(PacketBatch&&) noexcept = default;
+	PacketBatch& operator=(const PacketBatch&) = delete;
+	PacketBatch& operator=(PacketBatch&&) noexcept = default;
+
+	/**
+	 * @brief Returns the number of packets in the batch.
+	 * 
+	 * @return Number of packets
+	 */
+	[[nodiscard]] uint64_t size() const noexcept;
+
+	/**
+	 * @brief Checks whether the batch is empty.
+	 * 
+	 * @return `True` if the batch is empty, otherwise - `false`
+	 */
+	[[nodiscard]] bool empty() const noexcept;
+
+	/**
+	 * @brief Returns packet link layer types, pcapng files may mix interfaces of different types.
+	 * 
+	 * @return Packet link layer types
+	 */
+	[[nodiscard]] std::span<const uint32_t> linkLayerTypes() const noexcept;
+
+	/**
+	 * @brief Returns packet timestamps.
+	 * 
+	 * @return Packet timestamps `nanoseconds`
+	 */
+	[[nodiscard]] std::span<const uint64_t> timestamps() const noexcept;
+
+	/**
+	 * @brief Returns packet data offsets relative to the batch data.
+	 * 
+	 * @return Packet data offsets
+	 */
+	[[nodiscard]] std::span<const uint32_t> offsets() const noexcept;
+
+	/**
+	 * @brief Returns captured packet lengths.
+	 * 
+	 * @return Captured packet lengths
+	 */
+	[[nodiscard]] std::span<const uint32_t> lengths() const noexcept;
+
+	/**
+	 * @brief Returns original packet lengths.
+	 * 
+	 * @return Original packet lengths
+	 */
+	[[nodiscard]] std::span<const uint32_t> originalLengths() const noexcept;
+
+	/**
+	 * @brief Returns the contiguous batch data: packet records including their PCAP headers or pcapng blocks.
+	 * 
+	 * @return Batch data
+	 */
+	[[nodiscard]] std::span<const uint8_t> data() const noexcept;
+
+	/**
+	 * @brief Returns the data of a packet.
+	 * 
+	 * @param index Packet index
+	 * 
+	 * @return Packet data
+	 */
+	[[nodiscard]] std::span<const uint8_t> data(uint64_t index) const noexcept;
+
+	/**
+	 * @brief Fills out the packet with a view of the batch packet, no data is copied.
+	 * 
+	 * @param index Packet index
+	 * @param packet Packet
+	 */
+	void packet(uint64_t index, Packet& packet) const noexcept;
+
+	/**
+	 * @brief Extracts IPv4 5-tuples of all batch packets with SIMD kernels, without parsing the packets.
+	 * 
+	 * @param tuples 5-tuples, resized to the batch size
+	 */
+	void fiveTuples(std::vector<FiveTuple>& tuples) const;
+
+	/**
+	 * @brief Checks whether the batch data holds classic PCAP records of the given byte order and timestamp precision,
+	 * such records can be copied to another file as they are.
+	 * 
+	 * @param endian Byte order
+	 * @param nanoseconds Whether timestamps are in nanoseconds
+	 * 
+	 * @return `True` if the records match, otherwise - `false`
+	 */
+	[[nodiscard]] bool holdsRecords(std::endian endian, bool nanoseconds) const noexcept;
+
+	/**
+	 * @brief Removes all packets, keeping the allocated memory.
+	 */
+	void clear() noexcept;
+
+private:
+	friend class FileReader;
+
+	void reserveArena(uint64_t size);
+	void push(uint64_t timestamp, uint32_t offset, uint32_t length, uint32_t originalLength, uint32_t linkLayerType);
+	void decodeHeaders(std::endian endian, bool nanoseconds) noexcept;
+
+	std::unique_ptr<uint8_t[]> arena_;
+	uint64_t arenaSize_;
+	std::span<const uint8_t> data_;
+	std::vector<uint64_t> timestamps_;
+	std::vector<uint32_t> offsets_;
+	std::vector<uint32_t> lengths_;
+	std::vector<uint32_t> originalLengths_;
+	std::vector<uint32_t> linkLayerTypes_;
+	// set when the batch holds classic PCAP records
+	bool records_;
+	std::endian recordEndian_;
+	bool recordNanoseconds_;
+};
+} // namespace pcap
+
+#endif // PCAP_PACKET_BATCH_HPP
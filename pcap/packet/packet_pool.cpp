@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <utility>
+
+#include "packet_pool.hpp"
+
+namespace pcap
+{
+PacketPool::Handle::Handle() noexcept : pool_{nullptr}, packet_{nullptr} {}
+
+PacketPool::Handle::Handle(PacketPool* pool, Packet* packet) noexcept : pool_{pool}, packet_{packet} {}
+
+PacketPool::Handle::Handle(Handle&& handle) noexcept
+	: pool_{std::exchange(handle.pool_, nullptr)}
+	, packet_{std::exchange(handle.packet_, nullptr)}
+{
+}
+
+PacketPool::Handle& PacketPool::Handle::operator=(Handle&& handle) noexcept
+{
+	if (this != &handle)
+	{
+		release();
+
+		pool_ = std::exchange(handle.pool_, nullptr);
+		packet_ = std::exchange(handle.packet_, nullptr);
+	}
+
+	return *this;
+}
+
+PacketPool::Handle::~Handle()
+{
+	release();
+}
+
+Packet& PacketPool::Handle::operator*() const noexcept
+{
+	return *packet_;
+}
+
+Packet* PacketPool::Handle::operator->() const noexcept
+{
+	return packet_;
+}
+
+PacketPool::Handle::operator bool() const noexcept
+{
+	return packet_ != nullptr;
+}
+
+void PacketPool::Handle::release() noexcept
+{
+	if (packet_)
+	{
+		pool_->release(std::exchange(packet_, nullptr));
+		pool_ = nullptr;
+	}
+}
+
+PacketPool::PacketPool(uint64_t capacity) : mutex_{}, packets_{}, free_{}
+{
+	grow(capacity);
+}
+
+PacketPool::Handle PacketPool::acquire()
+{
+	std::lock_guard lock{mutex_};
+
+	if (free_.empty())
+	{
+		// doubling keeps the number of warm-up allocations logarithmic in the packets in flight
+		grow(std::max<uint64_t>(packets_.size(), 1));
+	}
+
+	auto* packet{free_.back()};
+	free_.pop_back();
+
+	return Handle{this, packet};
+}
+
+uint64_t PacketPool::capacity() const
+{
+	std::lock_guard lock{mutex_};
+	return packets_.size();
+}
+
+uint64_t PacketPool::available() const
+{
+	std::lock_guard lock{mutex_};
+	return free_.size();
+}
+
+void PacketPool::grow(uint64_t count)
+{
+	packets_.reserve(packets_.size() + count);
+	free_.reserve(packets_.size() + count);
+
+	for (uint64_t i{}; i < count; ++i)
+	{
+		packets_.push_back(std::make_unique<Packet>());
+		free_.push_back(packets_.back().get());
+	}
+}
+
+void PacketPool::release(Packet* packet) noexcept
+{
+	std::lock_guard lock{mutex_};
+	free_.push_back(packet);
+}
+} // namespace pcap
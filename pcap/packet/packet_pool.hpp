@@ -0,0 +1,97 @@
+#ifndef PCAP_PACKET_POOL_HPP
+#define PCAP_PACKET_POOL_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "packet.hpp"
+
+namespace pcap
+{
+/**
+ * @brief Pool of reusable packets for code that keeps packets around, e.g. in queues.
+ * 
+ * A released packet goes back to the pool with its byte storage and layer stack, so once the pool has grown
+ * to the number of packets in flight, acquiring, filling with `Packet::own()`, parsing and releasing
+ * do not allocate. Handles may be released from any thread, they must not outlive the pool.
+ */
+class PacketPool final
+{
+public:
+	/**
+	 * @brief Owning handle of a pooled packet, returns the packet to the pool when destroyed.
+	 */
+	class Handle final
+	{
+	public:
+		Handle() noexcept;
+		Handle(const Handle&) = delete;
+		Handle(Handle&& handle) noexcept;
+		Handle& operator=(const Handle&) = delete;
+		Handle& operator=(Handle&& handle) noexcept;
+		~Handle();
+
+		[[nodiscard]] Packet& operator*() const noexcept;
+		[[nodiscard]] Packet* operator->() const noexcept;
+		[[nodiscard]] explicit operator bool() const noexcept;
+
+		/**
+		 * @brief Returns the packet to the pool before the handle is destroyed.
+		 */
+		void release() noexcept;
+
+	private:
+		friend class PacketPool;
+
+		Handle(PacketPool* pool, Packet* packet) noexcept;
+
+		PacketPool* pool_;
+		Packet* packet_;
+	};
+
+	/**
+	 * @brief Creates a pool with packets allocated up front.
+	 * 
+	 * @param capacity Number of packets
+	 */
+	explicit PacketPool(uint64_t capacity = 0);
+	PacketPool(const PacketPool&) = delete;
+	PacketPool(PacketPool&&) = delete;
+	PacketPool& operator=(const PacketPool&) = delete;
+	PacketPool& operator=(PacketPool&&) = delete;
+
+	/**
+	 * @brief Takes a packet from the pool, a new one is allocated if the pool is empty.
+	 * 
+	 * @return Packet handle
+	 */
+	[[nodiscard]] Handle acquire();
+
+	/**
+	 * @brief Returns the number of packets allocated by the pool.
+	 * 
+	 * @return Number of packets
+	 */
+	[[nodiscard]] uint64_t capacity() const;
+
+	/**
+	 * @brief Returns the number of packets in the pool.
+	 * 
+	 * @return Number of free packets
+	 */
+	[[nodiscard]] uint64_t available() const;
+
+private:
+	void grow(uint64_t count);
+	void release(Packet* packet) noexcept;
+
+	mutable std::mutex mutex_;
+	std::vector<std::unique_ptr<Packet>> packets_;
+	// always has room for every packet, so releasing never allocates
+	std::vector<Packet*> free_;
+};
+} // namespace pcap
+
+#endif // PCAP_PACKET_POOL_HPP
@@ -0,0 +1,499 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PCAP_WITH_X86_KERNELS
+#endif
+
+#include "batch_decoder.hpp"
+
+constexpr uint32_t recordHeaderSize{16};
+constexpr uint32_t linkLayerTypeEthernet{1};
+constexpr uint32_t ethernetHeaderSize{14};
+constexpr uint32_t vlanTagSize{4};
+constexpr uint32_t ipv4HeaderSize{20};
+constexpr uint16_t etherTypeIPv4{0x0800};
+constexpr uint16_t etherTypeVlan{0x8100};
+constexpr uint16_t etherTypeQinQ{0x88a8};
+constexpr uint8_t protocolTcp{6};
+constexpr uint8_t protocolUdp{17};
+constexpr uint64_t hashStripeSize{32};
+constexpr uint64_t hashKeyStep{0x9e3779b97f4a7c15};
+alignas(32) constexpr uint64_t hashKeys[4]{0xc2b2ae3d27d4eb4f, 0x165667b19e3779f9, 0x85ebca77c2b2ae63, 0x27d4eb2f165667c5};
+
+namespace pcap
+{
+namespace
+{
+uint32_t loadHost32(const uint8_t* data, bool swap) noexcept
+{
+	uint32_t value{};
+	std::memcpy(&value, data, sizeof(value));
+
+	return swap ? std::byteswap(value) : value;
+}
+
+uint32_t loadNetwork32(const uint8_t* data) noexcept
+{
+	return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+
+uint16_t loadNetwork16(const uint8_t* data) noexcept
+{
+	return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+// offset of the IPv4 header of an Ethernet packet, VLAN tags are skipped: `0` if the packet is not an IPv4 one
+uint32_t ipv4HeaderOffset(std::span<const uint8_t> packet, uint32_t linkLayerType) noexcept
+{
+	if (linkLayerType != linkLayerTypeEthernet or packet.size() < ethernetHeaderSize + ipv4HeaderSize)
+	{
+		return 0;
+	}
+
+	// the ethertype of the last tag is the frame ethertype
+	auto headerSize{ethernetHeaderSize};
+	auto etherType{loadNetwork16(packet.data() + headerSize - sizeof(uint16_t))};
+
+	while ((etherType == etherTypeVlan or etherType == etherTypeQinQ) and headerSize + vlanTagSize + ipv4HeaderSize <= packet.size())
+	{
+		headerSize += vlanTagSize;
+		etherType = loadNetwork16(packet.data() + headerSize - sizeof(uint16_t));
+	}
+
+	const auto* ip{packet.data() + headerSize};
+	const auto ipHeaderLength{static_cast<uint32_t>(ip[0] & 0x0f) * 4};
+
+	if (etherType != etherTypeIPv4 or (ip[0] >> 4) != 4 or ipHeaderLength < ipv4HeaderSize or headerSize + ipHeaderLength > packet.size())
+	{
+		return 0;
+	}
+
+	return headerSize;
+}
+
+uint64_t mixHash(uint64_t value) noexcept
+{
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccd;
+	value ^= value >> 33;
+	value *= 0xc4ceb9fe1a85ec53;
+	value ^= value >> 33;
+
+	return value;
+}
+
+// every 64-bit lane is keyed by its stripe number, so the hash depends on the stripe order
+void hashStripesScalar(const uint8_t* data, uint64_t stripes, uint64_t first, uint64_t* accumulators) noexcept
+{
+	for (uint64_t stripe{}; stripe < stripes; ++stripe)
+	{
+		uint64_t lanes[4]{};
+		std::memcpy(lanes, data + stripe * hashStripeSize, hashStripeSize);
+
+		for (uint64_t lane{}; lane < 4; ++lane)
+		{
+			const auto keyed{lanes[lane] ^ (hashKeys[lane] + (first + stripe) * hashKeyStep)};
+			accumulators[lane] += lanes[lane ^ 1] + (keyed & 0xffffffff) * (keyed >> 32);
+		}
+	}
+}
+
+void decodePacketHeadersScalar(const uint8_t* data,
+			       const uint32_t* offsets,
+			       uint64_t count,
+			       bool swap,
+			       uint64_t fractionScale,
+			       uint64_t* timestamps,
+			       uint32_t* lengths,
+			       uint32_t* originalLengths) noexcept
+{
+	for (uint64_t i{}; i < count; ++i)
+	{
+		const auto* header{data + offsets[i] - recordHeaderSize};
+
+		timestamps[i] = loadHost32(header, swap) * 1'000'000'000ull + loadHost32(header + 4, swap) * fractionScale;
+		lengths[i] = loadHost32(header + 8, swap);
+		originalLengths[i] = loadHost32(header + 12, swap);
+	}
+}
+
+void extractFiveTuplesScalar(std::span<const uint8_t> data,
+			     const uint32_t* offsets,
+			     const uint32_t* lengths,
+			     const uint32_t* linkLayerTypes,
+			     uint64_t count,
+			     FiveTuple* tuples) noexcept
+{
+	for (uint64_t i{}; i < count; ++i)
+	{
+		tuples[i] = extractFiveTuple(data.subspan(offsets[i], lengths[i]), linkLayerTypes[i]);
+	}
+}
+
+#ifdef PCAP_WITH_X86_KERNELS
+__attribute__((target("sse4.1"))) void decodePacketHeadersSse41(const uint8_t* data,
+								 const uint32_t* offsets,
+								 uint64_t count,
+								 bool swap,
+								 uint64_t fractionScale,
+								 uint64_t* timestamps,
+								 uint32_t* lengths,
+								 uint32_t* originalLengths) noexcept
+{
+	const auto swapMask{_mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)};
+	const auto secondScale{_mm_set1_epi64x(1'000'000'000)};
+	const auto fractionScaleVector{_mm_set1_epi64x(static_cast<int64_t>(fractionScale))};
+	uint64_t i{};
+
+	// two headers per iteration: [seconds, fraction] and [captured, original] pairs are regrouped into 64-bit lanes
+	for (; i + 2 <= count; i += 2)
+	{
+		auto first{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offsets[i] - recordHeaderSize))};
+		auto second{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offsets[i + 1] - recordHeaderSize))};
+
+		if (swap)
+		{
+			first = _mm_shuffle_epi8(first, swapMask);
+			second = _mm_shuffle_epi8(second, swapMask);
+		}
+
+		const auto times{_mm_unpacklo_epi64(first, second)};
+		const auto sizes{_mm_unpackhi_epi64(first, second)};
+		const auto nanoseconds{_mm_add_epi64(_mm_mul_epu32(times, secondScale), _mm_mul_epu32(_mm_srli_epi64(times, 32), fractionScaleVector))};
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(timestamps + i), nanoseconds);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(lengths + i), _mm_shuffle_epi32(sizes, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(originalLengths + i), _mm_shuffle_epi32(sizes, _MM_SHUFFLE(3, 1, 3, 1)));
+	}
+
+	decodePacketHeadersScalar(data, offsets + i, count - i, swap, fractionScale, timestamps + i, lengths + i, originalLengths + i);
+}
+
+__attribute__((target("avx2"))) void decodePacketHeadersAvx2(const uint8_t* data,
+							       const uint32_t* offsets,
+							       uint64_t count,
+							       bool swap,
+							       uint64_t fractionScale,
+							       uint64_t* timestamps,
+							       uint32_t* lengths,
+							       uint32_t* originalLengths) noexcept
+{
+	const auto swapMask{_mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)};
+	const auto secondScale{_mm256_set1_epi64x(1'000'000'000)};
+	const auto fractionScaleVector{_mm256_set1_epi64x(static_cast<int64_t>(fractionScale))};
+	const auto splitSizes{_mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7)};
+	uint64_t i{};
+
+	// four headers per iteration
+	for (; i + 4 <= count; i += 4)
+	{
+		const auto load = [data](uint32_t offset) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset - recordHeaderSize)); };
+
+		auto first{_mm256_set_m128i(load(offsets[i + 1]), load(offsets[i]))};
+		auto second{_mm256_set_m128i(load(offsets[i + 3]), load(offsets[i + 2]))};
+
+		if (swap)
+		{
+			first = _mm256_shuffle_epi8(first, swapMask);
+			second = _mm256_shuffle_epi8(second, swapMask);
+		}
+
+		// unpacking works within 128-bit lanes and yields headers 0, 2, 1, 3: restore the order
+		const auto times{_mm256_permute4x64_epi64(_mm256_unpacklo_epi64(first, second), _MM_SHUFFLE(3, 1, 2, 0))};
+		const auto sizes{_mm256_permute4x64_epi64(_mm256_unpackhi_epi64(first, second), _MM_SHUFFLE(3, 1, 2, 0))};
+		const auto nanoseconds{
+			_mm256_add_epi64(_mm256_mul_epu32(times, secondScale), _mm256_mul_epu32(_mm256_srli_epi64(times, 32), fractionScaleVector))};
+		const auto split{_mm256_permutevar8x32_epi32(sizes, splitSizes)};
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(timestamps + i), nanoseconds);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lengths + i), _mm256_castsi256_si128(split));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(originalLengths + i), _mm256_extracti128_si256(split, 1));
+	}
+
+	decodePacketHeadersScalar(data, offsets + i, count - i, swap, fractionScale, timestamps + i, lengths + i, originalLengths + i);
+}
+
+__attribute__((target("avx2"))) void hashStripesAvx2(const uint8_t* data, uint64_t stripes, uint64_t first, uint64_t* accumulators) noexcept
+{
+	const auto step{_mm256_set1_epi64x(static_cast<int64_t>(hashKeyStep))};
+	auto key{_mm256_add_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(hashKeys)), _mm256_set1_epi64x(static_cast<int64_t>(first * hashKeyStep)))};
+	auto accumulator{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulators))};
+
+	// one stripe per iteration: the 32-bit halves of the keyed lanes are multiplied, the lanes of each pair are swapped and added
+	for (uint64_t stripe{}; stripe < stripes; ++stripe)
+	{
+		const auto lanes{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + stripe * hashStripeSize))};
+		const auto keyed{_mm256_xor_si256(lanes, key)};
+		const auto product{_mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32))};
+
+		accumulator = _mm256_add_epi64(accumulator, _mm256_add_epi64(_mm256_shuffle_epi32(lanes, _MM_SHUFFLE(1, 0, 3, 2)), product));
+		key = _mm256_add_epi64(key, step);
+	}
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulators), accumulator);
+}
+
+// gathers 4 bytes at `index + offset` of the lanes selected by the mask, zero in the other lanes
+__attribute__((target("avx2"))) inline __m256i gather(const int* base, __m256i index, __m256i mask, int offset) noexcept
+{
+	return _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base, _mm256_add_epi32(index, _mm256_set1_epi32(offset)), mask, 1);
+}
+
+__attribute__((target("avx2"))) void extractFiveTuplesAvx2(std::span<const uint8_t> data,
+							     const uint32_t* offsets,
+							     const uint32_t* lengths,
+							     const uint32_t* linkLayerTypes,
+							     uint64_t count,
+							     FiveTuple* tuples) noexcept
+{
+	const auto* base{reinterpret_cast<const int*>(data.data())};
+	const auto zero{_mm256_setzero_si256()};
+	const auto swapMask{_mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)};
+	const auto byte{_mm256_set1_epi32(0xff)};
+	uint64_t i{};
+
+	// eight packets per iteration: every field is gathered only from the packets where it is known to exist
+	for (; i + 8 <= count; i += 8)
+	{
+		const auto index{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + i))};
+		const auto length{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lengths + i))};
+		const auto linkLayerType{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(linkLayerTypes + i))};
+
+		auto valid{_mm256_and_si256(_mm256_cmpeq_epi32(linkLayerType, _mm256_set1_epi32(linkLayerTypeEthernet)),
+					    _mm256_cmpgt_epi32(length, _mm256_set1_epi32(ethernetHeaderSize + ipv4HeaderSize - 1)))};
+
+		if (_mm256_testz_si256(valid, valid))
+		{
+			std::memset(tuples + i, 0, 8 * sizeof(FiveTuple));
+			continue;
+		}
+
+		// bytes 12..15: ethertype, version and header length, service type
+		const auto ethernet{gather(base, index, valid, 12)};
+		const auto versionLength{_mm256_and_si256(_mm256_srli_epi32(ethernet, 16), byte)};
+		const auto headerLength{_mm256_slli_epi32(_mm256_and_si256(versionLength, _mm256_set1_epi32(0x0f)), 2)};
+
+		const auto etherType{_mm256_and_si256(ethernet, _mm256_set1_epi32(0xffff))};
+
+		// tagged frames are rare enough to be left to the scalar path, ethertypes are gathered in network byte order
+		const auto tagged{_mm256_movemask_ps(_mm256_castsi256_ps(
+			_mm256_and_si256(valid,
+					 _mm256_or_si256(_mm256_cmpeq_epi32(etherType, _mm256_set1_epi32(std::byteswap(etherTypeVlan))),
+							 _mm256_cmpeq_epi32(etherType, _mm256_set1_epi32(std::byteswap(etherTypeQinQ)))))))};
+
+		valid = _mm256_and_si256(valid, _mm256_cmpeq_epi32(etherType, _mm256_set1_epi32(std::byteswap(etherTypeIPv4))));
+		valid = _mm256_and_si256(valid, _mm256_cmpeq_epi32(_mm256_srli_epi32(versionLength, 4), _mm256_set1_epi32(4)));
+		valid = _mm256_and_si256(valid, _mm256_cmpgt_epi32(headerLength, _mm256_set1_epi32(ipv4HeaderSize - 1)));
+		valid = _mm256_andnot_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(headerLength, _mm256_set1_epi32(ethernetHeaderSize)), length), valid);
+
+		// bytes 20..23: fragment offset, time to live, protocol
+		const auto fragment{gather(base, index, valid, 20)};
+		const auto protocol{_mm256_and_si256(_mm256_srli_epi32(fragment, 24), byte)};
+		const auto source{_mm256_shuffle_epi8(gather(base, index, valid, 26), swapMask)};
+		const auto destination{_mm256_shuffle_epi8(gather(base, index, valid, 30), swapMask)};
+
+		auto hasPorts{_mm256_or_si256(_mm256_cmpeq_epi32(protocol, _mm256_set1_epi32(protocolUdp)),
+					      _mm256_cmpeq_epi32(protocol, _mm256_set1_epi32(protocolTcp)))};
+		hasPorts = _mm256_and_si256(hasPorts, valid);
+		hasPorts = _mm256_and_si256(hasPorts, _mm256_cmpeq_epi32(_mm256_and_si256(fragment, _mm256_set1_epi32(0xff1f)), zero));
+		hasPorts = _mm256_andnot_si256(
+			_mm256_cmpgt_epi32(_mm256_add_epi32(headerLength, _mm256_set1_epi32(ethernetHeaderSize + 2 * sizeof(uint16_t))), length), hasPorts);
+
+		const auto ports{gather(base, _mm256_add_epi32(index, headerLength), hasPorts, ethernetHeaderSize)};
+
+		alignas(32) uint32_t validLanes[8];
+		alignas(32) uint32_t protocols[8];
+		alignas(32) uint32_t sources[8];
+		alignas(32) uint32_t destinations[8];
+		alignas(32) uint32_t portPairs[8];
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(validLanes), valid);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(protocols), _mm256_and_si256(protocol, valid));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(sources), _mm256_and_si256(source, valid));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(destinations), _mm256_and_si256(destination, valid));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(portPairs), ports);
+
+		for (auto lane{0}; lane < 8; ++lane)
+		{
+			const auto pair{portPairs[lane]};
+
+			tuples[i + lane] = {sources[lane],
+					    destinations[lane],
+					    static_cast<uint16_t>(((pair & 0xff) << 8) | ((pair >> 8) & 0xff)),
+					    static_cast<uint16_t>(((pair >> 16) & 0xff) << 8 | (pair >> 24)),
+					    static_cast<uint8_t>(protocols[lane]),
+					    validLanes[lane] != 0};
+		}
+
+		for (auto lanes{static_cast<uint32_t>(tagged)}; lanes != 0; lanes &= lanes - 1)
+		{
+			const auto lane{std::countr_zero(lanes)};
+
+			tuples[i + lane] = extractFiveTuple(data.subspan(offsets[i + lane], lengths[i + lane]), linkLayerTypes[i + lane]);
+		}
+	}
+
+	extractFiveTuplesScalar(data, offsets + i, lengths + i, linkLayerTypes + i, count - i, tuples + i);
+}
+#endif
+} // namespace
+
+FiveTuple extractFiveTuple(std::span<const uint8_t> packet, uint32_t linkLayerType) noexcept
+{
+	FiveTuple tuple{};
+	const auto headerSize{ipv4HeaderOffset(packet, linkLayerType)};
+
+	if (headerSize == 0)
+	{
+		return tuple;
+	}
+
+	const auto* ip{packet.data() + headerSize};
+	const auto ipHeaderLength{static_cast<uint32_t>(ip[0] & 0x0f) * 4};
+
+	tuple.valid = true;
+	tuple.protocol = ip[9];
+	tuple.sourceAddress = loadNetwork32(ip + 12);
+	tuple.destinationAddress = loadNetwork32(ip + 16);
+
+	const auto firstFragment{(ip[6] & 0x1f) == 0 and ip[7] == 0};
+
+	if ((tuple.protocol == protocolUdp or tuple.protocol == protocolTcp) and firstFragment and
+	    headerSize + ipHeaderLength + 2 * sizeof(uint16_t) <= packet.size())
+	{
+		tuple.sourcePort = loadNetwork16(ip + ipHeaderLength);
+		tuple.destinationPort = loadNetwork16(ip + ipHeaderLength + 2);
+	}
+
+	return tuple;
+}
+
+SimdLevel simdLevel() noexcept
+{
+#ifdef PCAP_WITH_X86_KERNELS
+	static const auto level{[]
+				{
+					__builtin_cpu_init();
+
+					if (__builtin_cpu_supports("avx2"))
+					{
+						return SimdLevel::avx2;
+					}
+
+					if (__builtin_cpu_supports("sse4.1"))
+					{
+						return SimdLevel::sse41;
+					}
+
+					return SimdLevel::scalar;
+				}()};
+
+	return level;
+#else
+	return SimdLevel::scalar;
+#endif
+}
+
+void decodePacketHeaders(std::span<const uint8_t> data,
+			 std::span<const uint32_t> offsets,
+			 std::endian endian,
+			 bool nanoseconds,
+			 std::span<uint64_t> timestamps,
+			 std::span<uint32_t> lengths,
+			 std::span<uint32_t> originalLengths,
+			 SimdLevel level) noexcept
+{
+	const auto swap{endian != std::endian::native};
+	const uint64_t fractionScale{nanoseconds ? 1u : 1000u};
+
+	switch (level)
+	{
+#ifdef PCAP_WITH_X86_KERNELS
+	case SimdLevel::avx2:
+		decodePacketHeadersAvx2(data.data(), offsets.data(), offsets.size(), swap, fractionScale, timestamps.data(), lengths.data(), originalLengths.data());
+		break;
+	case SimdLevel::sse41:
+		decodePacketHeadersSse41(data.data(), offsets.data(), offsets.size(), swap, fractionScale, timestamps.data(), lengths.data(), originalLengths.data());
+		break;
+#endif
+	default:
+		decodePacketHeadersScalar(data.data(), offsets.data(), offsets.size(), swap, fractionScale, timestamps.data(), lengths.data(), originalLengths.data());
+	}
+}
+
+void extractFiveTuples(std::span<const uint8_t> data,
+		       std::span<const uint32_t> offsets,
+		       std::span<const uint32_t> lengths,
+		       std::span<const uint32_t> linkLayerTypes,
+		       std::span<FiveTuple> tuples,
+		       SimdLevel level) noexcept
+{
+#ifdef PCAP_WITH_X86_KERNELS
+	// gathers take signed 32-bit indices; SSE4.1 has no gathers, so it uses the scalar path
+	if (level == SimdLevel::avx2 and data.size() <= INT32_MAX)
+	{
+		extractFiveTuplesAvx2(data, offsets.data(), lengths.data(), linkLayerTypes.data(), offsets.size(), tuples.data());
+		return;
+	}
+#endif
+
+	extractFiveTuplesScalar(data, offsets.data(), lengths.data(), linkLayerTypes.data(), offsets.size(), tuples.data());
+}
+
+uint64_t hashPacket(std::span<const uint8_t> packet, uint32_t linkLayerType, SimdLevel level) noexcept
+{
+	uint64_t accumulators[4]{hashKeys[0], hashKeys[1], hashKeys[2], hashKeys[3]};
+	uint64_t stripe{};
+	const auto offset{ipv4HeaderOffset(packet, linkLayerType)};
+	auto data{packet.subspan(offset)};
+	const auto length{data.size()};
+
+	if (offset != 0)
+	{
+		// copies of a packet seen on other links differ in the link header, the TTL and the header checksum
+		uint8_t head[hashStripeSize]{};
+		std::memcpy(head, data.data(), std::min(hashStripeSize, data.size()));
+		head[8] = 0;
+		head[10] = 0;
+		head[11] = 0;
+
+		hashStripesScalar(head, 1, stripe++, accumulators);
+		data = data.subspan(std::min(hashStripeSize, data.size()));
+	}
+
+	const auto stripes{data.size() / hashStripeSize};
+
+#ifdef PCAP_WITH_X86_KERNELS
+	if (level == SimdLevel::avx2)
+	{
+		hashStripesAvx2(data.data(), stripes, stripe, accumulators);
+	}
+	else
+#endif
+	{
+		hashStripesScalar(data.data(), stripes, stripe, accumulators);
+	}
+
+	stripe += stripes;
+
+	if (const auto rest{data.size() % hashStripeSize})
+	{
+		uint8_t tail[hashStripeSize]{};
+		std::memcpy(tail, data.data() + stripes * hashStripeSize, rest);
+		hashStripesScalar(tail, 1, stripe, accumulators);
+	}
+
+	// the length tells apart data ending with zeroes from its padded stripe
+	auto hash{mixHash(length)};
+
+	for (const auto accumulator : accumulators)
+	{
+		hash = mixHash(hash ^ accumulator);
+	}
+
+	return hash;
+}
+} // namespace pcap
@@ -0,0 +1,88 @@
+#ifndef PCAP_UTILS_BATCH_DECODER_HPP
+#define PCAP_UTILS_BATCH_DECODER_HPP
+
+#include <bit>
+#include <cstdint>
+#include <span>
+
+#include "pcap/network_layer/five_tuple.hpp"
+
+namespace pcap
+{
+enum class SimdLevel : uint8_t
+{
+	scalar,
+	sse41,
+	avx2
+};
+
+/**
+ * @brief Returns the widest instruction set the kernels can use on this CPU, detected once at runtime.
+ * 
+ * @return SIMD level
+ */
+[[nodiscard]] SimdLevel simdLevel() noexcept;
+
+/**
+ * @brief Decodes PCAP record headers of many packets at once: byte-swaps them and converts timestamps to nanoseconds.
+ * 
+ * @param data Batch data
+ * @param offsets Packet data offsets, each preceded by its 16-byte record header
+ * @param endian File byte order
+ * @param nanoseconds Whether the file stores nanosecond timestamps
+ * @param timestamps Packet timestamps `nanoseconds`, one per offset
+ * @param lengths Captured packet lengths, one per offset
+ * @param originalLengths Original packet lengths, one per offset
+ * @param level SIMD level, the detected one by default
+ */
+void decodePacketHeaders(std::span<const uint8_t> data,
+			 std::span<const uint32_t> offsets,
+			 std::endian endian,
+			 bool nanoseconds,
+			 std::span<uint64_t> timestamps,
+			 std::span<uint32_t> lengths,
+			 std::span<uint32_t> originalLengths,
+			 SimdLevel level = simdLevel()) noexcept;
+
+/**
+ * @brief Extracts the IPv4 5-tuple of a single Ethernet packet, VLAN tags are skipped.
+ * 
+ * @param packet Captured packet bytes
+ * @param linkLayerType Link layer type
+ * 
+ * @return 5-tuple, invalid if the packet is not an Ethernet IPv4 packet
+ */
+[[nodiscard]] FiveTuple extractFiveTuple(std::span<const uint8_t> packet, uint32_t linkLayerType) noexcept;
+
+/**
+ * @brief Extracts IPv4 5-tuples of many Ethernet packets at once, see `extractFiveTuple()`.
+ * 
+ * @param data Batch data
+ * @param offsets Packet data offsets
+ * @param lengths Captured packet lengths
+ * @param linkLayerTypes Packet link layer types
+ * @param tuples 5-tuples, one per offset
+ * @param level SIMD level, the detected one by default
+ */
+void extractFiveTuples(std::span<const uint8_t> data,
+		       std::span<const uint32_t> offsets,
+		       std::span<const uint32_t> lengths,
+		       std::span<const uint32_t> linkLayerTypes,
+		       std::span<FiveTuple> tuples,
+		       SimdLevel level = simdLevel()) noexcept;
+
+/**
+ * @brief Hashes captured packet bytes 32 at a time, e.g. to find duplicates. For Ethernet IPv4 packets only the bytes
+ * from the IPv4 header on are hashed, with the TTL and the header checksum ignored, so copies of a packet forwarded
+ * between links hash alike.
+ * 
+ * @param packet Captured packet bytes
+ * @param linkLayerType Link layer type
+ * @param level SIMD level, the detected one by default: every level gives the same hash
+ * 
+ * @return 64-bit hash
+ */
+[[nodiscard]] uint64_t hashPacket(std::span<const uint8_t> packet, uint32_t linkLayerType, SimdLevel level = simdLevel()) noexcept;
+} // namespace pcap
+
+#endif // PCAP_UTILS_BATCH_DECODER_HPP
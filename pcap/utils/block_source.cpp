@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstring>
+
+#include "block_source.hpp"
+
+namespace pcap
+{
+BlockSource::BlockSource() noexcept : block_{}, current_{}, position_{}, offset_{} {}
+
+uint64_t BlockSource::read(void* data, uint64_t size)
+{
+	uint64_t readBytes{};
+
+	while (readBytes < size and acquire())
+	{
+		const auto length{std::min(size - readBytes, block_.size() - position_)};
+
+		std::memcpy(static_cast<uint8_t*>(data) + readBytes, block_.data() + position_, length);
+		position_ += length;
+		offset_ += length;
+		readBytes += length;
+	}
+
+	return readBytes;
+}
+
+uint64_t BlockSource::peek(void* data, uint64_t size)
+{
+	if (not acquire())
+	{
+		return 0;
+	}
+
+	auto length{std::min(size, block_.size() - position_)};
+	std::memcpy(data, block_.data() + position_, length);
+
+	for (auto sequence{current_ + 1}; length < size; ++sequence)
+	{
+		const auto next{block(sequence)};
+
+		if (next.empty())
+		{
+			break;
+		}
+
+		const auto nextLength{std::min(size - length, next.size())};
+		std::memcpy(static_cast<uint8_t*>(data) + length, next.data(), nextLength);
+		length += nextLength;
+	}
+
+	return length;
+}
+
+std::span<const uint8_t> BlockSource::view(uint64_t size, std::vector<uint8_t>& scratch)
+{
+	if (acquire() and block_.size() - position_ >= size)
+	{
+		const auto data{block_.subspan(position_, size)};
+		position_ += size;
+		offset_ += size;
+
+		return data;
+	}
+
+	scratch.resize(size);
+
+	return {scratch.data(), static_cast<size_t>(read(scratch.data(), size))};
+}
+
+uint64_t BlockSource::skip(uint64_t size)
+{
+	uint64_t skipped{};
+
+	while (skipped < size and acquire())
+	{
+		const auto length{std::min(size - skipped, block_.size() - position_)};
+
+		position_ += length;
+		offset_ += length;
+		skipped += length;
+	}
+
+	return skipped;
+}
+
+void BlockSource::seek(uint64_t offset)
+{
+	reset(restart(offset));
+	skip(offset - offset_);
+}
+
+bool BlockSource::eof()
+{
+	return not acquire();
+}
+
+uint64_t BlockSource::offset() const noexcept
+{
+	return offset_;
+}
+
+void BlockSource::reset(uint64_t offset) noexcept
+{
+	block_ = {};
+	current_ = 0;
+	position_ = 0;
+	offset_ = offset;
+}
+
+bool BlockSource::acquire()
+{
+	if (position_ < block_.size())
+	{
+		return true;
+	}
+
+	if (not block_.empty())
+	{
+		// the consumed block is only released now, so a view returned by the previous call stays valid until this one
+		release(current_++);
+	}
+
+	block_ = block(current_);
+	position_ = 0;
+
+	return not block_.empty();
+}
+} // namespace pcap
@@ -0,0 +1,132 @@
+#ifndef PCAP_UTILS_BLOCK_SOURCE_HPP
+#define PCAP_UTILS_BLOCK_SOURCE_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pcap
+{
+/**
+ * @brief Sequential byte stream delivered in blocks produced ahead of the consumer.
+ * 
+ * Derived classes produce the blocks, this class implements consumption on top of them. A block is released
+ * to its producer only when the consumer moves past it, so views stay valid until the next call.
+ */
+class BlockSource
+{
+public:
+	BlockSource(const BlockSource&) = delete;
+	BlockSource(BlockSource&&) = delete;
+	BlockSource& operator=(const BlockSource&) = delete;
+	BlockSource& operator=(BlockSource&&) = delete;
+	virtual ~BlockSource() = default;
+
+	/**
+	 * @brief Copies the next bytes of the stream.
+	 * 
+	 * @param data Destination
+	 * @param size Number of bytes
+	 * 
+	 * @return Number of bytes copied, less than `size` only at the end of stream
+	 */
+	uint64_t read(void* data, uint64_t size);
+
+	/**
+	 * @brief Copies the next bytes of the stream without consuming them.
+	 * 
+	 * @param data Destination
+	 * @param size Number of bytes, not larger than a block
+	 * 
+	 * @return Number of bytes copied, less than `size` only at the end of stream
+	 */
+	uint64_t peek(void* data, uint64_t size);
+
+	/**
+	 * @brief Returns a view of the next bytes of the stream, valid until the next call.
+	 * 
+	 * The view refers to a block when the bytes are contiguous there, otherwise they are copied to `scratch`.
+	 * 
+	 * @param size Number of bytes
+	 * @param scratch Scratch buffer
+	 * 
+	 * @return View of the next bytes, shorter than `size` only at the end of stream
+	 */
+	std::span<const uint8_t> view(uint64_t size, std::vector<uint8_t>& scratch);
+
+	/**
+	 * @brief Skips the next bytes of the stream.
+	 * 
+	 * @param size Number of bytes
+	 * 
+	 * @return Number of bytes skipped, less than `size` only at the end of stream
+	 */
+	virtual uint64_t skip(uint64_t size);
+
+	/**
+	 * @brief Moves to an offset of the stream.
+	 * 
+	 * @param offset Stream offset
+	 */
+	void seek(uint64_t offset);
+
+	/**
+	 * @brief Checks whether the whole stream was consumed.
+	 * 
+	 * @return `True` if the end of stream was reached, otherwise - `false`
+	 */
+	[[nodiscard]] bool eof();
+
+	/**
+	 * @brief Returns the offset of the next byte to consume.
+	 * 
+	 * @return Stream offset
+	 */
+	[[nodiscard]] uint64_t offset() const noexcept;
+
+protected:
+	BlockSource() noexcept;
+
+	/**
+	 * @brief Waits for a block to be produced.
+	 * 
+	 * @param sequence Block sequence number since the last restart
+	 * 
+	 * @return Block data, empty at the end of stream
+	 */
+	virtual std::span<const uint8_t> block(uint64_t sequence) = 0;
+
+	/**
+	 * @brief Hands a consumed block back to the producer.
+	 * 
+	 * @param sequence Block sequence number since the last restart
+	 */
+	virtual void release(uint64_t sequence) = 0;
+
+	/**
+	 * @brief Restarts block production at or before an offset.
+	 * 
+	 * @param offset Stream offset
+	 * 
+	 * @return Offset of the first byte of the first produced block
+	 */
+	virtual uint64_t restart(uint64_t offset) = 0;
+
+	/**
+	 * @brief Forgets the consumer position, used when a derived class (re)starts production.
+	 * 
+	 * @param offset Stream offset of the first block
+	 */
+	void reset(uint64_t offset) noexcept;
+
+private:
+	bool acquire();
+
+	std::span<const uint8_t> block_;
+	uint64_t current_;
+	uint64_t position_;
+	uint64_t offset_;
+};
+} // namespace pcap
+
+#endif // PCAP_UTILS_BLOCK_SOURCE_HPP
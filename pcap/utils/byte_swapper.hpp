@@ -16,6 +16,7 @@
 #include <bit>
 
 #include "pcap/file_reader/file_reader.hpp"
+#include "pcap/file_reader/pcapng_decoder.hpp"
 #include "pcap/network_layer/network_layers.hpp"
 
 namespace pcap
@@ -45,20 +46,83 @@ struct ByteSwapper final
 		}
 	}
 
+	void operator()(PcapngDecoder::BlockHeader& header, std::endian endian) const noexcept
+	{
+		if (endian != std::endian::native)
+		{
+			header.type = bswap32(header.type);
+			header.length = bswap32(header.length);
+		}
+	}
+
+	void operator()(PcapngDecoder::SectionHeaderBlock& block, std::endian endian) const noexcept
+	{
+		if (endian != std::endian::native)
+		{
+			block.length = bswap32(block.length);
+			block.byteOrderMagic = bswap32(block.byteOrderMagic);
+			block.versionMajor = bswap16(block.versionMajor);
+			block.versionMinor = bswap16(block.versionMinor);
+			block.sectionLength = bswap64(block.sectionLength);
+		}
+	}
+
+	void operator()(PcapngDecoder::InterfaceDescriptionBlock& block, std::endian endian) const noexcept
+	{
+		if (endian != std::endian::native)
+		{
+			block.type = bswap32(block.type);
+			block.length = bswap32(block.length);
+			block.linkLayerType = bswap16(block.linkLayerType);
+			block.snapLength = bswap32(block.snapLength);
+		}
+	}
+
+	void operator()(PcapngDecoder::EnhancedPacketBlock& block, std::endian endian) const noexcept
+	{
+		if (endian != std::endian::native)
+		{
+			block.type = bswap32(block.type);
+			block.length = bswap32(block.length);
+			block.interfaceId = bswap32(block.interfaceId);
+			block.timestampHigh = bswap32(block.timestampHigh);
+			block.timestampLow = bswap32(block.timestampLow);
+			block.capturedLength = bswap32(block.capturedLength);
+			block.originalLength = bswap32(block.originalLength);
+		}
+	}
+
+	void operator()(PcapngDecoder::SimplePacketBlock& block, std::endian endian) const noexcept
+	{
+		if (endian != std::endian::native)
+		{
+			block.type = bswap32(block.type);
+			block.length = bswap32(block.length);
+			block.originalLength = bswap32(block.originalLength);
+		}
+	}
+
+	// network layers are decoded from network byte order to host byte order, addresses of bytes are kept as is
 	void operator()(network_layer::Ethernet& ethernet) const noexcept
 	{
-		if constexpr (std::endian::native != std::endian::little)
+		if constexpr (std::endian::native == std::endian::little)
 		{
-			// TODO
-			// swap destination
-			// swap source
 			ethernet.type = bswap16(ethernet.type);
 		}
 	}
 
+	void operator()(network_layer::Vlan& vlan) const noexcept
+	{
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			vlan.tagControl = bswap16(vlan.tagControl);
+			vlan.type = bswap16(vlan.type);
+		}
+	}
+
 	void operator()(network_layer::IPv4& ipv4) const noexcept
 	{
-		if constexpr (std::endian::native != std::endian::little)
+		if constexpr (std::endian::native == std::endian::little)
 		{
 			ipv4.totalLength = bswap16(ipv4.totalLength);
 			ipv4.identification = bswap16(ipv4.identification);
@@ -69,9 +133,32 @@ struct ByteSwapper final
 		}
 	}
 
+	void operator()(network_layer::IPv6& ipv6) const noexcept
+	{
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			ipv6.versionClassLabel = bswap32(ipv6.versionClassLabel);
+			ipv6.payloadLength = bswap16(ipv6.payloadLength);
+		}
+	}
+
+	void operator()(network_layer::Tcp& tcp) const noexcept
+	{
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			tcp.sourcePort = bswap16(tcp.sourcePort);
+			tcp.destinationPort = bswap16(tcp.destinationPort);
+			tcp.sequenceNumber = bswap32(tcp.sequenceNumber);
+			tcp.acknowledgmentNumber = bswap32(tcp.acknowledgmentNumber);
+			tcp.window = bswap16(tcp.window);
+			tcp.checksum = bswap16(tcp.checksum);
+			tcp.urgentPointer = bswap16(tcp.urgentPointer);
+		}
+	}
+
 	void operator()(network_layer::Udp& udp) const noexcept
 	{
-		if constexpr (std::endian::native != std::endian::little)
+		if constexpr (std::endian::native == std::endian::little)
 		{
 			udp.sourcePort = bswap16(udp.sourcePort);
 			udp.destinationPort = bswap16(udp.destinationPort);
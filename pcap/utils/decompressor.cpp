@@ -0,0 +1,499 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef PCAP_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef PCAP_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef PCAP_WITH_LZ4
+#include <lz4frame.h>
+#endif
+
+#include "decompressor.hpp"
+#include "metrics.hpp"
+
+constexpr uint8_t magicNumberGzip[]{0x1f, 0x8b};
+constexpr uint8_t magicNumberZstd[]{0x28, 0xb5, 0x2f, 0xfd};
+constexpr uint8_t magicNumberLz4[]{0x04, 0x22, 0x4d, 0x18};
+
+namespace pcap
+{
+namespace
+{
+class Codec
+{
+public:
+	virtual ~Codec() = default;
+
+	/**
+	 * @brief Decompresses as much input as fits into the output, consumed input is removed from `input`.
+	 * 
+	 * @return Number of bytes written to the output
+	 */
+	virtual uint64_t decompress(std::span<const uint8_t>& input, std::span<uint8_t> output) = 0;
+
+	/**
+	 * @brief Checks whether the last frame of the stream is complete.
+	 */
+	[[nodiscard]] virtual bool finished() const noexcept = 0;
+};
+
+#ifdef PCAP_WITH_ZLIB
+class GzipCodec final : public Codec
+{
+public:
+	GzipCodec() : stream_{}, finished_{}
+	{
+		// 32: detect gzip or zlib headers automatically
+		if (inflateInit2(&stream_, MAX_WBITS + 32) != Z_OK)
+		{
+			throw std::runtime_error("pcap::Decompressor [exception]: cannot initialize gzip decompression");
+		}
+	}
+
+	~GzipCodec() override
+	{
+		inflateEnd(&stream_);
+	}
+
+	uint64_t decompress(std::span<const uint8_t>& input, std::span<uint8_t> output) override
+	{
+		if (finished_)
+		{
+			// concatenated gzip members form a single stream
+			inflateReset(&stream_);
+			finished_ = false;
+		}
+
+		stream_.next_in = const_cast<Bytef*>(input.data());
+		stream_.avail_in = static_cast<uInt>(std::min<uint64_t>(input.size(), UINT32_MAX));
+		stream_.next_out = output.data();
+		stream_.avail_out = static_cast<uInt>(std::min<uint64_t>(output.size(), UINT32_MAX));
+
+		const auto result{inflate(&stream_, Z_NO_FLUSH)};
+
+		if (result != Z_OK and result != Z_STREAM_END and result != Z_BUF_ERROR)
+		{
+			throw std::runtime_error(std::format("pcap::Decompressor [exception]: gzip stream corrupted: {}", stream_.msg ? stream_.msg : "unknown error"));
+		}
+
+		finished_ = result == Z_STREAM_END;
+		input = input.subspan(input.size() - stream_.avail_in);
+
+		return output.size() - stream_.avail_out;
+	}
+
+	bool finished() const noexcept override
+	{
+		return finished_;
+	}
+
+private:
+	z_stream stream_;
+	bool finished_;
+};
+#endif
+
+#ifdef PCAP_WITH_ZSTD
+class ZstdCodec final : public Codec
+{
+public:
+	ZstdCodec() : stream_{ZSTD_createDStream()}, finished_{}
+	{
+		if (stream_ == nullptr)
+		{
+			throw std::runtime_error("pcap::Decompressor [exception]: cannot initialize zstd decompression");
+		}
+	}
+
+	~ZstdCodec() override
+	{
+		ZSTD_freeDStream(stream_);
+	}
+
+	uint64_t decompress(std::span<const uint8_t>& input, std::span<uint8_t> output) override
+	{
+		ZSTD_inBuffer in{input.data(), input.size(), 0};
+		ZSTD_outBuffer out{output.data(), output.size(), 0};
+
+		const auto result{ZSTD_decompressStream(stream_, &out, &in)};
+
+		if (ZSTD_isError(result))
+		{
+			throw std::runtime_error(std::format("pcap::Decompressor [exception]: zstd stream corrupted: {}", ZSTD_getErrorName(result)));
+		}
+
+		finished_ = result == 0;
+		input = input.subspan(in.pos);
+
+		return out.pos;
+	}
+
+	bool finished() const noexcept override
+	{
+		return finished_;
+	}
+
+private:
+	ZSTD_DStream* stream_;
+	bool finished_;
+};
+#endif
+
+#ifdef PCAP_WITH_LZ4
+class Lz4Codec final : public Codec
+{
+public:
+	Lz4Codec() : context_{}, finished_{}
+	{
+		if (LZ4F_isError(LZ4F_createDecompressionContext(&context_, LZ4F_VERSION)))
+		{
+			throw std::runtime_error("pcap::Decompressor [exception]: cannot initialize lz4 decompression");
+		}
+	}
+
+	~Lz4Codec() override
+	{
+		LZ4F_freeDecompressionContext(context_);
+	}
+
+	uint64_t decompress(std::span<const uint8_t>& input, std::span<uint8_t> output) override
+	{
+		auto inputSize{input.size()};
+		auto outputSize{output.size()};
+
+		const auto result{LZ4F_decompress(context_, output.data(), &outputSize, input.data(), &inputSize, nullptr)};
+
+		if (LZ4F_isError(result))
+		{
+			throw std::runtime_error(std::format("pcap::Decompressor [exception]: lz4 stream corrupted: {}", LZ4F_getErrorName(result)));
+		}
+
+		finished_ = result == 0;
+		input = input.subspan(inputSize);
+
+		return outputSize;
+	}
+
+	bool finished() const noexcept override
+	{
+		return finished_;
+	}
+
+private:
+	LZ4F_dctx* context_;
+	bool finished_;
+};
+#endif
+
+std::unique_ptr<Codec> makeCodec(Decompressor::Format format)
+{
+	switch (format)
+	{
+#ifdef PCAP_WITH_ZLIB
+	case Decompressor::Format::gzip:
+		return std::make_unique<GzipCodec>();
+#endif
+#ifdef PCAP_WITH_ZSTD
+	case Decompressor::Format::zstd:
+		return std::make_unique<ZstdCodec>();
+#endif
+#ifdef PCAP_WITH_LZ4
+	case Decompressor::Format::lz4:
+		return std::make_unique<Lz4Codec>();
+#endif
+	default:
+		throw std::runtime_error("pcap::Decompressor [exception]: compression format is not supported");
+	}
+}
+} // namespace
+
+Decompressor::Decompressor() noexcept
+	: bufferSize_{}
+	, fileSize_{}
+	, producedBlocks_{}
+	, releasedBlocks_{}
+	, format_{Format::none}
+	, finished_{}
+{
+}
+
+Decompressor::~Decompressor()
+{
+	close();
+}
+
+Decompressor::Format Decompressor::detect(std::span<const uint8_t> data) noexcept
+{
+	if (data.size() >= std::size(magicNumberGzip) and !std::memcmp(data.data(), magicNumberGzip, std::size(magicNumberGzip)))
+	{
+		return Format::gzip;
+	}
+
+	if (data.size() >= std::size(magicNumberZstd) and !std::memcmp(data.data(), magicNumberZstd, std::size(magicNumberZstd)))
+	{
+		return Format::zstd;
+	}
+
+	if (data.size() >= std::size(magicNumberLz4) and !std::memcmp(data.data(), magicNumberLz4, std::size(magicNumberLz4)))
+	{
+		return Format::lz4;
+	}
+
+	return Format::none;
+}
+
+Decompressor::Format Decompressor::detect(const std::string& fileName)
+{
+	uint8_t buffer[4]{};
+	std::ifstream file{fileName, std::ios::binary};
+	const auto size{file.read(reinterpret_cast<char*>(buffer), sizeof(buffer)).gcount()};
+
+	return detect({buffer, static_cast<size_t>(size)});
+}
+
+bool Decompressor::supports(Format format) noexcept
+{
+	switch (format)
+	{
+#ifdef PCAP_WITH_ZLIB
+	case Format::gzip:
+		return true;
+#endif
+#ifdef PCAP_WITH_ZSTD
+	case Format::zstd:
+		return true;
+#endif
+#ifdef PCAP_WITH_LZ4
+	case Format::lz4:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+bool Decompressor::open(const std::string& fileName, const Options& options)
+{
+	close();
+
+	std::ifstream file{fileName, std::ios::binary | std::ios::ate};
+
+	if (not file.is_open())
+	{
+		return false;
+	}
+
+	format_ = detect(fileName);
+
+	if (not supports(format_))
+	{
+		format_ = Format::none;
+		return false;
+	}
+
+	fileName_ = fileName;
+	fileSize_ = static_cast<uint64_t>(file.tellg());
+	bufferSize_ = std::max<uint64_t>(options.bufferSize, 4096);
+
+	// at least two blocks: one being consumed, one being decompressed
+	blocks_.resize(std::max<uint32_t>(options.queueDepth, 2));
+
+	for (auto& block : blocks_)
+	{
+		block.data = std::make_unique_for_overwrite<uint8_t[]>(bufferSize_);
+	}
+
+	seek(0);
+
+	return true;
+}
+
+bool Decompressor::isOpen() const noexcept
+{
+	return format_ != Format::none;
+}
+
+void Decompressor::close()
+{
+	stop();
+
+	blocks_.clear();
+	fileName_.clear();
+	fileSize_ = 0;
+	format_ = Format::none;
+	reset(0);
+}
+
+uint64_t Decompressor::size() const noexcept
+{
+	return fileSize_;
+}
+
+Decompressor::Format Decompressor::format() const noexcept
+{
+	return format_;
+}
+
+std::span<const uint8_t> Decompressor::block(uint64_t sequence)
+{
+	std::unique_lock lock{mutex_};
+
+	if (producedBlocks_ <= sequence and not finished_)
+	{
+		PCAP_METRICS(const auto start{std::chrono::steady_clock::now()});
+		produced_.wait(lock, [this, sequence] { return producedBlocks_ > sequence or finished_; });
+		PCAP_METRICS(Metrics::recordStall(std::chrono::steady_clock::now() - start));
+	}
+
+	if (producedBlocks_ > sequence)
+	{
+		const auto& block{blocks_[sequence % blocks_.size()]};
+		return {block.data.get(), static_cast<size_t>(block.size)};
+	}
+
+	if (exception_)
+	{
+		std::rethrow_exception(exception_);
+	}
+
+	return {};
+}
+
+void Decompressor::release(uint64_t sequence)
+{
+	{
+		std::lock_guard lock{mutex_};
+		releasedBlocks_ = sequence + 1;
+	}
+
+	released_.notify_one();
+}
+
+uint64_t Decompressor::restart(uint64_t)
+{
+	// compressed streams cannot be entered in the middle: decompress again from the beginning
+	stop();
+	start();
+
+	return 0;
+}
+
+void Decompressor::start()
+{
+	producedBlocks_ = 0;
+	releasedBlocks_ = 0;
+	finished_ = false;
+	exception_ = nullptr;
+
+	worker_ = std::jthread{[this](std::stop_token token) { work(token); }};
+}
+
+void Decompressor::stop()
+{
+	if (worker_.joinable())
+	{
+		{
+			std::lock_guard lock{mutex_};
+			worker_.request_stop();
+		}
+
+		released_.notify_all();
+		worker_.join();
+	}
+}
+
+void Decompressor::work(std::stop_token token)
+{
+	try
+	{
+		std::ifstream file{fileName_, std::ios::binary};
+		const auto codec{makeCodec(format_)};
+		const auto input{std::make_unique_for_overwrite<uint8_t[]>(bufferSize_)};
+		std::span<const uint8_t> pending{};
+		auto endOfFile{false};
+
+		for (uint64_t sequence{};; ++sequence)
+		{
+			{
+				std::unique_lock lock{mutex_};
+				released_.wait(lock, [this, &token, sequence] { return sequence - releasedBlocks_ < blocks_.size() or token.stop_requested(); });
+
+				if (token.stop_requested())
+				{
+					return;
+				}
+			}
+
+			auto& block{blocks_[sequence % blocks_.size()]};
+			block.size = 0;
+
+			while (block.size < bufferSize_)
+			{
+				if (pending.empty())
+				{
+					if (endOfFile)
+					{
+						break;
+					}
+
+					PCAP_METRICS(const auto start{std::chrono::steady_clock::now()});
+					const auto size{file.read(reinterpret_cast<char*>(input.get()), static_cast<std::streamsize>(bufferSize_)).gcount()};
+					PCAP_METRICS(Metrics::recordRead(std::chrono::steady_clock::now() - start, size));
+					pending = {input.get(), static_cast<size_t>(size)};
+					endOfFile = not file;
+
+					continue;
+				}
+
+				const auto pendingSize{pending.size()};
+				const auto size{codec->decompress(pending, {block.data.get() + block.size, bufferSize_ - block.size})};
+
+				if (size == 0 and pending.size() == pendingSize)
+				{
+					throw std::runtime_error("pcap::Decompressor [exception]: compressed stream corrupted");
+				}
+
+				block.size += size;
+			}
+
+			if (block.size == 0)
+			{
+				if (not codec->finished())
+				{
+					throw std::runtime_error("pcap::Decompressor [exception]: compressed stream truncated");
+				}
+
+				break;
+			}
+
+			{
+				std::lock_guard lock{mutex_};
+				++producedBlocks_;
+			}
+
+			produced_.notify_one();
+		}
+	}
+	catch (...)
+	{
+		std::lock_guard lock{mutex_};
+		exception_ = std::current_exception();
+	}
+
+	{
+		std::lock_guard lock{mutex_};
+		finished_ = true;
+	}
+
+	produced_.notify_one();
+}
+} // namespace pcap
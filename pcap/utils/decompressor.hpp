@@ -0,0 +1,139 @@
+#ifndef PCAP_UTILS_DECOMPRESSOR_HPP
+#define PCAP_UTILS_DECOMPRESSOR_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "block_source.hpp"
+
+namespace pcap
+{
+/**
+ * @brief Streaming decompressor of gzip, zstd and lz4 files. Decompression runs on its own thread and fills
+ * up to `queueDepth` blocks ahead of the consumer.
+ */
+class Decompressor final : public BlockSource
+{
+public:
+	enum class Format : uint8_t
+	{
+		none,
+		gzip,
+		zstd,
+		lz4
+	};
+
+	struct Options
+	{
+		uint32_t queueDepth{4};
+		uint64_t bufferSize{1024 * 1024};
+	};
+
+	Decompressor() noexcept;
+	Decompressor(const Decompressor&) = delete;
+	Decompressor(Decompressor&&) = delete;
+	Decompressor& operator=(const Decompressor&) = delete;
+	Decompressor& operator=(Decompressor&&) = delete;
+	~Decompressor() override;
+
+	/**
+	 * @brief Detects the compression format from magic bytes.
+	 * 
+	 * @param data Beginning of the file
+	 * 
+	 * @return Compression format, `Format::none` if the data is not compressed
+	 */
+	[[nodiscard]] static Format detect(std::span<const uint8_t> data) noexcept;
+
+	/**
+	 * @brief Detects the compression format of a file from its magic bytes.
+	 * 
+	 * @param fileName File name
+	 * 
+	 * @return Compression format, `Format::none` if the file is not compressed or cannot be opened
+	 */
+	[[nodiscard]] static Format detect(const std::string& fileName);
+
+	/**
+	 * @brief Checks whether the compression format support was compiled in.
+	 * 
+	 * @param format Compression format
+	 * 
+	 * @return `True` if the format is supported, otherwise - `false`
+	 */
+	[[nodiscard]] static bool supports(Format format) noexcept;
+
+	/**
+	 * @brief Opens the file and starts decompressing it.
+	 * 
+	 * @param fileName File name
+	 * @param options Decompression options
+	 * 
+	 * @return `True` if the file was opened and its format is supported, otherwise - `false`
+	 */
+	[[nodiscard]] bool open(const std::string& fileName, const Options& options);
+
+	/**
+	 * @brief Checks whether the file is opened.
+	 * 
+	 * @return `True` if the file is opened, otherwise - `false`
+	 */
+	[[nodiscard]] bool isOpen() const noexcept;
+
+	/**
+	 * @brief Stops decompression and closes the file.
+	 */
+	void close();
+
+	/**
+	 * @brief Returns the compressed file size.
+	 * 
+	 * @return Compressed file size
+	 */
+	[[nodiscard]] uint64_t size() const noexcept;
+
+	/**
+	 * @brief Returns the compression format.
+	 * 
+	 * @return Compression format
+	 */
+	[[nodiscard]] Format format() const noexcept;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<uint8_t[]> data;
+		uint64_t size;
+	};
+
+	std::span<const uint8_t> block(uint64_t sequence) override;
+	void release(uint64_t sequence) override;
+	uint64_t restart(uint64_t offset) override;
+
+	void start();
+	void stop();
+	void work(std::stop_token token);
+
+	std::vector<Block> blocks_;
+	std::jthread worker_;
+	std::mutex mutex_;
+	std::condition_variable produced_;
+	std::condition_variable released_;
+	std::exception_ptr exception_;
+	std::string fileName_;
+	uint64_t bufferSize_;
+	uint64_t fileSize_;
+	uint64_t producedBlocks_;
+	uint64_t releasedBlocks_;
+	Format format_;
+	bool finished_;
+};
+} // namespace pcap
+
+#endif // PCAP_UTILS_DECOMPRESSOR_HPP
@@ -0,0 +1,170 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include "event_loop.hpp"
+
+namespace pcap
+{
+EventLoop::EventLoop() : EventLoop(Options{}) {}
+
+EventLoop::EventLoop(const Options& options)
+	: options_{options}
+	, ring_{}
+	, ready_{}
+	, waiting_{}
+	, completed_{}
+	, exception_{}
+	, tasks_{}
+	, inFlight_{}
+{
+	options_.queueDepth = std::max<uint32_t>(options_.queueDepth, 1);
+
+	if (options_.ioUring)
+	{
+		static_cast<void>(ring_.open(options_.queueDepth));
+	}
+}
+
+EventLoop::~EventLoop()
+{
+	for (auto coroutine : ready_)
+	{
+		coroutine.destroy();
+	}
+}
+
+void EventLoop::spawn(Task task)
+{
+	auto handle{std::exchange(task.handle_, nullptr)};
+
+	handle.promise().loop = this;
+	ready_.push_back(handle);
+	++tasks_;
+}
+
+void EventLoop::run()
+{
+	while (tasks_ != 0)
+	{
+		while (not ready_.empty() or not completed_.empty())
+		{
+			while (not ready_.empty())
+			{
+				const auto coroutine{ready_.front()};
+				ready_.pop_front();
+				coroutine.resume();
+			}
+
+			while (not completed_.empty())
+			{
+				const auto [read, result]{completed_.front()};
+				completed_.pop_front();
+				read->complete(*read, result);
+			}
+		}
+
+		if (tasks_ == 0)
+		{
+			break;
+		}
+
+		if (inFlight_ == 0)
+		{
+			throw std::runtime_error("pcap::EventLoop [exception]: tasks are suspended, but no read is in flight.");
+		}
+
+		reap();
+	}
+
+	if (exception_)
+	{
+		std::rethrow_exception(std::exchange(exception_, nullptr));
+	}
+}
+
+void EventLoop::submit(Read& read)
+{
+	if (not ring_.isOpen())
+	{
+		const auto result{::pread(read.descriptor, read.data, read.size, static_cast<off_t>(read.offset))};
+		completed_.emplace_back(&read, result == -1 ? -errno : static_cast<int32_t>(result));
+
+		return;
+	}
+
+	if (inFlight_ == options_.queueDepth)
+	{
+		waiting_.push_back(&read);
+		return;
+	}
+
+	start(read);
+}
+
+void EventLoop::schedule(std::coroutine_handle<> coroutine)
+{
+	ready_.push_back(coroutine);
+}
+
+EventLoop::ReadAwaiter EventLoop::read(int descriptor, void* data, uint32_t size, uint64_t offset) noexcept
+{
+	return ReadAwaiter{*this, descriptor, data, size, offset};
+}
+
+bool EventLoop::usesIoUring() const noexcept
+{
+	return ring_.isOpen();
+}
+
+void EventLoop::finish(std::coroutine_handle<Task::promise_type> task) noexcept
+{
+	if (task.promise().exception and not exception_)
+	{
+		exception_ = task.promise().exception;
+	}
+
+	task.destroy();
+	--tasks_;
+}
+
+void EventLoop::start(Read& read)
+{
+	if (not ring_.read(read.descriptor, read.data, read.size, read.offset, reinterpret_cast<uint64_t>(&read)))
+	{
+		throw std::runtime_error("pcap::EventLoop [exception]: cannot submit a read: submission queue is full.");
+	}
+
+	++inFlight_;
+}
+
+void EventLoop::reap()
+{
+	IoUring::Completion completion{};
+
+	if (not ring_.wait(completion))
+	{
+		throw std::runtime_error(std::format("pcap::EventLoop [exception]: cannot wait for a read: {}.", std::strerror(errno)));
+	}
+
+	do
+	{
+		--inFlight_;
+
+		// a slot is free: the oldest waiting read takes it before the completion can submit a new one
+		if (not waiting_.empty())
+		{
+			auto* read{waiting_.front()};
+			waiting_.pop_front();
+			start(*read);
+		}
+
+		auto* read{reinterpret_cast<Read*>(completion.userData)};
+		read->complete(*read, completion.result);
+	} while (ring_.poll(completion));
+}
+} // namespace pcap
@@ -0,0 +1,238 @@
+#ifndef PCAP_UTILS_EVENT_LOOP_HPP
+#define PCAP_UTILS_EVENT_LOOP_HPP
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <utility>
+
+#include "io_uring.hpp"
+
+namespace pcap
+{
+/**
+ * @brief Single-threaded event loop running coroutines on top of asynchronous file reads.
+ * 
+ * Reads of every coroutine share one io_uring, so a single thread multiplexes any number of files: a coroutine
+ * waiting for data is suspended and the loop resumes another one. Without io_uring support reads are made with
+ * `pread()` when submitted, coroutines still work but the thread blocks on each read.
+ */
+class EventLoop final
+{
+public:
+	struct Options
+	{
+		// reads in flight at once, the others wait for a free slot
+		uint32_t queueDepth{256};
+		bool ioUring{true};
+	};
+
+	/**
+	 * @brief Asynchronous read, `complete` is called on the loop thread with the number of bytes read or `-errno`.
+	 * The request must stay alive until then.
+	 */
+	struct Read
+	{
+		int descriptor;
+		void* data;
+		uint32_t size;
+		uint64_t offset;
+		void (*complete)(Read& read, int32_t result);
+		void* context;
+	};
+
+	/**
+	 * @brief Coroutine run by the loop, e.g. `EventLoop::Task process(AsyncFileReader& reader)`, started by `spawn()`.
+	 */
+	class Task final
+	{
+	public:
+		struct promise_type
+		{
+			EventLoop* loop{};
+
+			Task get_return_object() noexcept
+			{
+				return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+			}
+
+			std::suspend_always initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			auto final_suspend() noexcept
+			{
+				struct Finish
+				{
+					bool await_ready() noexcept
+					{
+						return false;
+					}
+
+					void await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+					{
+						handle.promise().loop->finish(handle);
+					}
+
+					void await_resume() noexcept {}
+				};
+
+				return Finish{};
+			}
+
+			void return_void() noexcept {}
+
+			void unhandled_exception() noexcept
+			{
+				exception = std::current_exception();
+			}
+
+			std::exception_ptr exception;
+		};
+
+		Task(const Task&) = delete;
+		Task(Task&& task) noexcept : handle_{std::exchange(task.handle_, nullptr)} {}
+		Task& operator=(const Task&) = delete;
+		Task& operator=(Task&&) = delete;
+
+		~Task()
+		{
+			// a task that was never spawned
+			if (handle_)
+			{
+				handle_.destroy();
+			}
+		}
+
+	private:
+		friend class EventLoop;
+
+		explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_{handle} {}
+
+		std::coroutine_handle<promise_type> handle_;
+	};
+
+	/**
+	 * @brief Awaitable read of a coroutine, `co_await` yields the number of bytes read or `-errno`.
+	 */
+	class ReadAwaiter final
+	{
+	public:
+		ReadAwaiter(EventLoop& loop, int descriptor, void* data, uint32_t size, uint64_t offset) noexcept
+			: loop_{loop}
+			, read_{descriptor, data, size, offset, &ReadAwaiter::complete, this}
+			, waiter_{}
+			, result_{}
+		{
+		}
+
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> waiter)
+		{
+			waiter_ = waiter;
+			loop_.submit(read_);
+		}
+
+		int32_t await_resume() const noexcept
+		{
+			return result_;
+		}
+
+	private:
+		static void complete(Read& read, int32_t result)
+		{
+			auto& awaiter{*static_cast<ReadAwaiter*>(read.context)};
+
+			awaiter.result_ = result;
+			awaiter.loop_.schedule(awaiter.waiter_);
+		}
+
+		EventLoop& loop_;
+		Read read_;
+		std::coroutine_handle<> waiter_;
+		int32_t result_;
+	};
+
+	EventLoop();
+	explicit EventLoop(const Options& options);
+	EventLoop(const EventLoop&) = delete;
+	EventLoop(EventLoop&&) = delete;
+	EventLoop& operator=(const EventLoop&) = delete;
+	EventLoop& operator=(EventLoop&&) = delete;
+
+	/**
+	 * @brief Destroys the tasks spawned but never run.
+	 */
+	~EventLoop();
+
+	/**
+	 * @brief Hands a task over to the loop, it starts on the next `run()`.
+	 * 
+	 * @param task Task
+	 */
+	void spawn(Task task);
+
+	/**
+	 * @brief Runs the tasks on the calling thread until all of them are finished, then rethrows the first exception
+	 * a task ended with.
+	 */
+	void run();
+
+	/**
+	 * @brief Submits a read, it waits for a free slot when `queueDepth` reads are already in flight.
+	 * 
+	 * @param read Read request
+	 */
+	void submit(Read& read);
+
+	/**
+	 * @brief Resumes a coroutine on the next loop iteration.
+	 * 
+	 * @param coroutine Suspended coroutine
+	 */
+	void schedule(std::coroutine_handle<> coroutine);
+
+	/**
+	 * @brief Reads from a file asynchronously, e.g. `const auto size{co_await loop.read(descriptor, data, size, offset)}`.
+	 * 
+	 * @param descriptor File descriptor
+	 * @param data Destination buffer
+	 * @param size Number of bytes to read
+	 * @param offset File offset
+	 * 
+	 * @return Read awaitable
+	 */
+	[[nodiscard]] ReadAwaiter read(int descriptor, void* data, uint32_t size, uint64_t offset) noexcept;
+
+	/**
+	 * @brief Checks whether reads go through io_uring.
+	 * 
+	 * @return `True` if reads go through io_uring, otherwise - `false`
+	 */
+	[[nodiscard]] bool usesIoUring() const noexcept;
+
+private:
+	void finish(std::coroutine_handle<Task::promise_type> task) noexcept;
+	void start(Read& read);
+	void reap();
+
+	Options options_;
+	IoUring ring_;
+	std::deque<std::coroutine_handle<>> ready_;
+	// reads waiting for a slot
+	std::deque<Read*> waiting_;
+	// reads made with `pread()`, completed on the next iteration
+	std::deque<std::pair<Read*, int32_t>> completed_;
+	std::exception_ptr exception_;
+	uint64_t tasks_;
+	uint64_t inFlight_;
+};
+} // namespace pcap
+
+#endif // PCAP_UTILS_EVENT_LOOP_HPP
@@ -0,0 +1,244 @@
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include "io_uring.hpp"
+
+namespace pcap
+{
+namespace
+{
+uint32_t loadAcquire(uint32_t* value) noexcept
+{
+	return std::atomic_ref{*value}.load(std::memory_order_acquire);
+}
+
+void storeRelease(uint32_t* value, uint32_t newValue) noexcept
+{
+	std::atomic_ref{*value}.store(newValue, std::memory_order_release);
+}
+
+int enter(int descriptor, uint32_t submit, uint32_t complete, uint32_t flags) noexcept
+{
+	int result{};
+
+	do
+	{
+		result = static_cast<int>(::syscall(__NR_io_uring_enter, descriptor, submit, complete, flags, nullptr, 0));
+	} while (result == -1 and errno == EINTR);
+
+	return result;
+}
+
+template <typename T>
+T* at(void* base, uint32_t offset) noexcept
+{
+	return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+}
+} // namespace
+
+IoUring::IoUring() noexcept
+	: submissionRing_{MAP_FAILED}
+	, completionRing_{MAP_FAILED}
+	, submissionEntries_{MAP_FAILED}
+	, submissionRingSize_{}
+	, completionRingSize_{}
+	, submissionEntriesSize_{}
+	, submissionHead_{}
+	, submissionTail_{}
+	, submissionMask_{}
+	, submissionArray_{}
+	, completionHead_{}
+	, completionTail_{}
+	, completionMask_{}
+	, completionEntries_{}
+	, unsubmitted_{}
+	, descriptor_{-1}
+{
+}
+
+IoUring::~IoUring()
+{
+	close();
+}
+
+bool IoUring::open(uint32_t entries) noexcept
+{
+	close();
+
+	io_uring_params params{};
+	descriptor_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+
+	if (descriptor_ == -1)
+	{
+		return false;
+	}
+
+	submissionRingSize_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	completionRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		submissionRingSize_ = completionRingSize_ = std::max(submissionRingSize_, completionRingSize_);
+	}
+
+	submissionRing_ = ::mmap(nullptr, submissionRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor_, IORING_OFF_SQ_RING);
+
+	if (submissionRing_ == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		completionRing_ = submissionRing_;
+	}
+	else
+	{
+		completionRing_ = ::mmap(nullptr, completionRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor_, IORING_OFF_CQ_RING);
+
+		if (completionRing_ == MAP_FAILED)
+		{
+			close();
+			return false;
+		}
+	}
+
+	submissionEntriesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+	submissionEntries_ = ::mmap(nullptr, submissionEntriesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor_, IORING_OFF_SQES);
+
+	if (submissionEntries_ == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	submissionHead_ = at<uint32_t>(submissionRing_, params.sq_off.head);
+	submissionTail_ = at<uint32_t>(submissionRing_, params.sq_off.tail);
+	submissionMask_ = at<uint32_t>(submissionRing_, params.sq_off.ring_mask);
+	submissionArray_ = at<uint32_t>(submissionRing_, params.sq_off.array);
+	completionHead_ = at<uint32_t>(completionRing_, params.cq_off.head);
+	completionTail_ = at<uint32_t>(completionRing_, params.cq_off.tail);
+	completionMask_ = at<uint32_t>(completionRing_, params.cq_off.ring_mask);
+	completionEntries_ = at<void>(completionRing_, params.cq_off.cqes);
+
+	return true;
+}
+
+bool IoUring::isOpen() const noexcept
+{
+	return descriptor_ != -1;
+}
+
+void IoUring::close() noexcept
+{
+	if (submissionEntries_ != MAP_FAILED)
+	{
+		::munmap(submissionEntries_, submissionEntriesSize_);
+	}
+
+	if (completionRing_ != MAP_FAILED and completionRing_ != submissionRing_)
+	{
+		::munmap(completionRing_, completionRingSize_);
+	}
+
+	if (submissionRing_ != MAP_FAILED)
+	{
+		::munmap(submissionRing_, submissionRingSize_);
+	}
+
+	if (descriptor_ != -1)
+	{
+		::close(descriptor_);
+	}
+
+	submissionRing_ = completionRing_ = submissionEntries_ = MAP_FAILED;
+	unsubmitted_ = 0;
+	descriptor_ = -1;
+}
+
+bool IoUring::read(int descriptor, void* data, uint32_t size, uint64_t offset, uint64_t userData) noexcept
+{
+	const auto tail{*submissionTail_};
+
+	if (tail - loadAcquire(submissionHead_) > *submissionMask_)
+	{
+		return false;
+	}
+
+	const auto index{tail & *submissionMask_};
+	auto* entry{static_cast<io_uring_sqe*>(submissionEntries_) + index};
+
+	std::memset(entry, 0, sizeof(io_uring_sqe));
+	entry->opcode = IORING_OP_READ;
+	entry->fd = descriptor;
+	entry->addr = reinterpret_cast<uint64_t>(data);
+	entry->len = size;
+	entry->off = offset;
+	entry->user_data = userData;
+
+	submissionArray_[index] = index;
+	storeRelease(submissionTail_, tail + 1);
+	++unsubmitted_;
+
+	// the entry is published: the kernel may take it at any later `io_uring_enter()`, so from now on the read is in flight
+	// whatever this call returns. Entries it does not take now, e.g. on `EAGAIN` or `EBUSY`, are submitted by `wait()`
+	if (const auto submitted{enter(descriptor_, unsubmitted_, 0, 0)}; submitted > 0)
+	{
+		unsubmitted_ -= static_cast<uint32_t>(submitted);
+	}
+
+	return true;
+}
+
+bool IoUring::wait(Completion& completion) noexcept
+{
+	while (not poll(completion))
+	{
+		const auto submitted{enter(descriptor_, unsubmitted_, 1, IORING_ENTER_GETEVENTS)};
+
+		if (submitted != -1)
+		{
+			unsubmitted_ -= static_cast<uint32_t>(submitted);
+			continue;
+		}
+
+		// the kernel is short of resources for new entries until completions are reaped: only wait this time
+		if (unsubmitted_ == 0 or (errno != EAGAIN and errno != EBUSY) or enter(descriptor_, 0, 1, IORING_ENTER_GETEVENTS) == -1)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool IoUring::poll(Completion& completion) noexcept
+{
+	const auto head{*completionHead_};
+
+	if (head == loadAcquire(completionTail_))
+	{
+		return false;
+	}
+
+	const auto* entry{static_cast<const io_uring_cqe*>(completionEntries_) + (head & *completionMask_)};
+	completion = {entry->user_data, entry->res};
+
+	storeRelease(completionHead_, head + 1);
+
+	return true;
+}
+
+int IoUring::descriptor() const noexcept
+{
+	return descriptor_;
+}
+} // namespace pcap
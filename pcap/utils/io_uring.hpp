@@ -0,0 +1,108 @@
+#ifndef PCAP_UTILS_IO_URING_HPP
+#define PCAP_UTILS_IO_URING_HPP
+
+#include <cstdint>
+
+namespace pcap
+{
+/**
+ * @brief Minimal io_uring submission/completion ring for asynchronous file reads, set up through raw system calls.
+ */
+class IoUring final
+{
+public:
+	struct Completion
+	{
+		uint64_t userData;
+		int32_t result;
+	};
+
+	IoUring() noexcept;
+	IoUring(const IoUring&) = delete;
+	IoUring(IoUring&&) = delete;
+	IoUring& operator=(const IoUring&) = delete;
+	IoUring& operator=(IoUring&&) = delete;
+	~IoUring();
+
+	/**
+	 * @brief Sets up the ring.
+	 * 
+	 * @param entries Number of submission queue entries
+	 * 
+	 * @return `True` if the kernel supports io_uring and the ring was set up, otherwise - `false`
+	 */
+	[[nodiscard]] bool open(uint32_t entries) noexcept;
+
+	/**
+	 * @brief Checks whether the ring is set up.
+	 * 
+	 * @return `True` if the ring is set up, otherwise - `false`
+	 */
+	[[nodiscard]] bool isOpen() const noexcept;
+
+	/**
+	 * @brief Tears down the ring, in-flight requests are abandoned.
+	 */
+	void close() noexcept;
+
+	/**
+	 * @brief Submits an asynchronous read. Once queued the read is in flight: entries the kernel cannot take at once
+	 * are submitted again by the next `read()` or `wait()`, so every queued read ends with a completion.
+	 * 
+	 * @param descriptor File descriptor
+	 * @param data Destination buffer
+	 * @param size Number of bytes to read
+	 * @param offset File offset
+	 * @param userData Value returned with the completion
+	 * 
+	 * @return `True` if the read was queued, `false` if the submission queue is full
+	 */
+	[[nodiscard]] bool read(int descriptor, void* data, uint32_t size, uint64_t offset, uint64_t userData) noexcept;
+
+	/**
+	 * @brief Waits for a completion.
+	 * 
+	 * @param completion Completion
+	 * 
+	 * @return `True` if a completion was received, otherwise - `false`
+	 */
+	[[nodiscard]] bool wait(Completion& completion) noexcept;
+
+	/**
+	 * @brief Takes a completion if one is available without waiting.
+	 * 
+	 * @param completion Completion
+	 * 
+	 * @return `True` if a completion was received, otherwise - `false`
+	 */
+	[[nodiscard]] bool poll(Completion& completion) noexcept;
+
+	/**
+	 * @brief Returns the ring file descriptor, it becomes readable when completions are available.
+	 * 
+	 * @return Ring file descriptor
+	 */
+	[[nodiscard]] int descriptor() const noexcept;
+
+private:
+	void* submissionRing_;
+	void* completionRing_;
+	void* submissionEntries_;
+	uint64_t submissionRingSize_;
+	uint64_t completionRingSize_;
+	uint64_t submissionEntriesSize_;
+	uint32_t* submissionHead_;
+	uint32_t* submissionTail_;
+	uint32_t* submissionMask_;
+	uint32_t* submissionArray_;
+	uint32_t* completionHead_;
+	uint32_t* completionTail_;
+	uint32_t* completionMask_;
+	void* completionEntries_;
+	// published entries the kernel has not taken yet
+	uint32_t unsubmitted_;
+	int descriptor_;
+};
+} // namespace pcap
+
+#endif // PCAP_UTILS_IO_URING_HPP
@@ -0,0 +1,54 @@
+#include <atomic>
+#include <iostream>
+
+#include "log.hpp"
+
+namespace pcap
+{
+namespace
+{
+std::atomic<LogSink> logSink{nullptr};
+std::atomic<LogLevel> logLevel{LogLevel::none};
+
+constexpr std::string_view levelName(LogLevel level) noexcept
+{
+	switch (level)
+	{
+	case LogLevel::debug:
+		return "debug";
+	case LogLevel::info:
+		return "info";
+	case LogLevel::warning:
+		return "warning";
+	case LogLevel::error:
+		return "error";
+	default:
+		return "";
+	}
+}
+} // namespace
+
+void setLogSink(LogSink sink, LogLevel level) noexcept
+{
+	logLevel.store(sink ? level : LogLevel::none, std::memory_order_relaxed);
+	logSink.store(sink, std::memory_order_release);
+}
+
+void standardErrorLogSink(LogLevel level, std::string_view message)
+{
+	std::cerr << std::format("[{}] {}\n", levelName(level), message);
+}
+
+bool logEnabled(LogLevel level) noexcept
+{
+	return level >= logLevel.load(std::memory_order_relaxed) and level != LogLevel::none;
+}
+
+void log(LogLevel level, std::string_view message)
+{
+	if (const auto sink{logSink.load(std::memory_order_acquire)})
+	{
+		sink(level, message);
+	}
+}
+} // namespace pcap
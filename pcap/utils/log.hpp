@@ -0,0 +1,73 @@
+#ifndef PCAP_UTILS_LOG_HPP
+#define PCAP_UTILS_LOG_HPP
+
+#include <cstdint>
+#include <format>
+#include <string_view>
+
+namespace pcap
+{
+enum class LogLevel : uint8_t
+{
+	debug,
+	info,
+	warning,
+	error,
+	// disables every message
+	none
+};
+
+/**
+ * @brief Receives the library messages, it may be called from any thread.
+ */
+using LogSink = void (*)(LogLevel level, std::string_view message);
+
+/**
+ * @brief Installs the sink receiving the messages of at least `level`, no sink is installed by default.
+ * 
+ * @param sink Log sink, `nullptr` disables logging
+ * @param level Minimal level of passed messages
+ */
+void setLogSink(LogSink sink, LogLevel level = LogLevel::info) noexcept;
+
+/**
+ * @brief Log sink writing the messages to `std::cerr`.
+ * 
+ * @param level Message level
+ * @param message Message
+ */
+void standardErrorLogSink(LogLevel level, std::string_view message);
+
+/**
+ * @brief Checks whether messages of `level` reach a sink, so that disabled messages are not formatted.
+ * 
+ * @param level Message level
+ * 
+ * @return `True` if the messages are passed to the sink, otherwise - `false`
+ */
+[[nodiscard]] bool logEnabled(LogLevel level) noexcept;
+
+/**
+ * @brief Passes a message to the installed sink.
+ * 
+ * @param level Message level
+ * @param message Message
+ */
+void log(LogLevel level, std::string_view message);
+} // namespace pcap
+
+// the library logs through `PCAP_LOG()` only: without `PCAP_WITH_LOGGING` messages are not even compiled
+#ifdef PCAP_WITH_LOGGING
+#define PCAP_LOG(level, ...)                                                \
+	do                                                                  \
+	{                                                                   \
+		if (::pcap::logEnabled(level)) [[unlikely]]                \
+		{                                                           \
+			::pcap::log(level, std::format(__VA_ARGS__));       \
+		}                                                           \
+	} while (false)
+#else
+#define PCAP_LOG(level, ...) static_cast<void>(0)
+#endif
+
+#endif // PCAP_UTILS_LOG_HPP
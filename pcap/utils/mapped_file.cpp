@@ -0,0 +1,122 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "mapped_file.hpp"
+
+namespace pcap
+{
+MappedFile::MappedFile() noexcept : data_{nullptr}, size_{}, descriptor_{-1} {}
+
+MappedFile::MappedFile(MappedFile&& file) noexcept : data_{nullptr}, size_{}, descriptor_{-1}
+{
+	std::swap(data_, file.data_);
+	std::swap(size_, file.size_);
+	std::swap(descriptor_, file.descriptor_);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& file) noexcept
+{
+	if (this != &file)
+	{
+		close();
+
+		std::swap(data_, file.data_);
+		std::swap(size_, file.size_);
+		std::swap(descriptor_, file.descriptor_);
+	}
+
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string& fileName, bool hugePages) noexcept
+{
+	close();
+
+	descriptor_ = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (descriptor_ == -1)
+	{
+		return false;
+	}
+
+	struct stat status{};
+
+	if (::fstat(descriptor_, &status) == -1)
+	{
+		close();
+		return false;
+	}
+
+	size_ = static_cast<uint64_t>(status.st_size);
+
+	if (size_ == 0)
+	{
+		return true;
+	}
+
+	auto* mapping{::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor_, 0)};
+
+	if (mapping == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	data_ = static_cast<const uint8_t*>(mapping);
+
+	// advices are best effort: a kernel that ignores them still gives a valid mapping
+	::madvise(mapping, size_, MADV_SEQUENTIAL);
+
+#ifdef MADV_HUGEPAGE
+	if (hugePages)
+	{
+		::madvise(mapping, size_, MADV_HUGEPAGE);
+	}
+#else
+	static_cast<void>(hugePages);
+#endif
+
+	return true;
+}
+
+bool MappedFile::isOpen() const noexcept
+{
+	return descriptor_ != -1;
+}
+
+void MappedFile::close() noexcept
+{
+	if (data_ != nullptr)
+	{
+		::munmap(const_cast<uint8_t*>(data_), size_);
+	}
+
+	if (descriptor_ != -1)
+	{
+		::close(descriptor_);
+	}
+
+	data_ = nullptr;
+	size_ = 0;
+	descriptor_ = -1;
+}
+
+std::span<const uint8_t> MappedFile::data() const noexcept
+{
+	return {data_, static_cast<size_t>(size_)};
+}
+
+uint64_t MappedFile::size() const noexcept
+{
+	return size_;
+}
+} // namespace pcap
@@ -0,0 +1,63 @@
+#ifndef PCAP_UTILS_MAPPED_FILE_HPP
+#define PCAP_UTILS_MAPPED_FILE_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace pcap
+{
+class MappedFile final
+{
+public:
+	MappedFile() noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&&) noexcept;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&&) noexcept;
+	~MappedFile();
+
+	/**
+	 * @brief Maps the whole file into memory read-only and advises the kernel about sequential access.
+	 * 
+	 * @param fileName File name
+	 * @param hugePages Indicates that transparent huge pages should be requested for the mapping
+	 * 
+	 * @return `True` if the file was successfully mapped, otherwise - `false`
+	 */
+	[[nodiscard]] bool open(const std::string& fileName, bool hugePages = false) noexcept;
+
+	/**
+	 * @brief Checks whether the file is mapped.
+	 * 
+	 * @return `True` if the file is mapped, otherwise - `false`
+	 */
+	[[nodiscard]] bool isOpen() const noexcept;
+
+	/**
+	 * @brief Unmaps the file.
+	 */
+	void close() noexcept;
+
+	/**
+	 * @brief Returns the mapped file contents.
+	 * 
+	 * @return Mapped file contents
+	 */
+	[[nodiscard]] std::span<const uint8_t> data() const noexcept;
+
+	/**
+	 * @brief Returns the mapped file size.
+	 * 
+	 * @return Mapped file size
+	 */
+	[[nodiscard]] uint64_t size() const noexcept;
+
+private:
+	const uint8_t* data_;
+	uint64_t size_;
+	int descriptor_;
+};
+} // namespace pcap
+
+#endif // PCAP_UTILS_MAPPED_FILE_HPP
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <mutex>
+
+#include "metrics.hpp"
+
+namespace pcap
+{
+namespace
+{
+using Counter = std::atomic<uint64_t>;
+
+// recorded by the owning thread only, relaxed atomics let snapshots and resets access them concurrently
+struct Counters
+{
+	Counter reads;
+	Counter readBytes;
+	Counter stallTime;
+	std::array<Counter, Metrics::histogramBuckets> readLatency;
+	std::array<Counter, Metrics::histogramBuckets> readSize;
+	std::array<Counter, Metrics::parseFailureReasons> parseFailures;
+	// type + 1, zero marks a free slot
+	std::array<std::atomic<uint32_t>, Metrics::unsupportedLayerTypes> unsupportedLayerTypes;
+	std::array<Counter, Metrics::unsupportedLayerTypes> unsupportedLayers;
+	Counter otherUnsupportedLayers;
+};
+
+struct Registry
+{
+	std::mutex mutex;
+	std::vector<Counters*> threads;
+	// counters of finished threads
+	Metrics::Snapshot finished{};
+};
+
+Registry& registry()
+{
+	// never destroyed: threads may finish after static destruction started
+	static auto* registry{new Registry{}};
+	return *registry;
+}
+
+void add(Counter& counter, uint64_t value) noexcept
+{
+	counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t bucket(uint64_t value) noexcept
+{
+	return std::min<uint64_t>(std::bit_width(value), Metrics::histogramBuckets - 1);
+}
+
+void addUnsupportedLayer(Metrics::Snapshot& snapshot, uint32_t type, uint64_t count)
+{
+	const auto found{std::ranges::find(snapshot.unsupportedLayers, type, &std::pair<uint32_t, uint64_t>::first)};
+
+	if (found != snapshot.unsupportedLayers.end())
+	{
+		found->second += count;
+	}
+	else
+	{
+		snapshot.unsupportedLayers.emplace_back(type, count);
+	}
+}
+
+void accumulate(Metrics::Snapshot& snapshot, const Counters& counters)
+{
+	constexpr auto relaxed{std::memory_order_relaxed};
+
+	snapshot.reads += counters.reads.load(relaxed);
+	snapshot.readBytes += counters.readBytes.load(relaxed);
+	snapshot.stallTime += std::chrono::nanoseconds{counters.stallTime.load(relaxed)};
+
+	for (uint64_t i{}; i < Metrics::histogramBuckets; ++i)
+	{
+		snapshot.readLatency.buckets[i] += counters.readLatency[i].load(relaxed);
+		snapshot.readSize.buckets[i] += counters.readSize[i].load(relaxed);
+	}
+
+	for (uint64_t i{}; i < Metrics::parseFailureReasons; ++i)
+	{
+		snapshot.parseFailures[i] += counters.parseFailures[i].load(relaxed);
+	}
+
+	for (uint64_t i{}; i < Metrics::unsupportedLayerTypes; ++i)
+	{
+		const auto type{counters.unsupportedLayerTypes[i].load(relaxed)};
+		const auto count{counters.unsupportedLayers[i].load(relaxed)};
+
+		// slots stay claimed after a reset
+		if (type != 0 and count != 0)
+		{
+			addUnsupportedLayer(snapshot, type - 1, count);
+		}
+	}
+
+	snapshot.otherUnsupportedLayers += counters.otherUnsupportedLayers.load(relaxed);
+}
+
+// registers the counters of a thread on first use, folds them into the finished ones when the thread exits
+class ThreadCounters final
+{
+public:
+	ThreadCounters() : counters_{}
+	{
+		auto& threads{registry()};
+		std::lock_guard lock{threads.mutex};
+		threads.threads.push_back(&counters_);
+	}
+
+	ThreadCounters(const ThreadCounters&) = delete;
+	ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+	~ThreadCounters()
+	{
+		auto& threads{registry()};
+		std::lock_guard lock{threads.mutex};
+		accumulate(threads.finished, counters_);
+		std::erase(threads.threads, &counters_);
+	}
+
+	Counters& counters() noexcept
+	{
+		return counters_;
+	}
+
+private:
+	Counters counters_;
+};
+
+Counters& local() noexcept
+{
+	thread_local ThreadCounters counters;
+	return counters.counters();
+}
+} // namespace
+
+uint64_t Metrics::Histogram::count() const noexcept
+{
+	uint64_t count{};
+
+	for (const auto value : buckets)
+	{
+		count += value;
+	}
+
+	return count;
+}
+
+uint64_t Metrics::Histogram::percentile(double fraction) const noexcept
+{
+	const auto rank{static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count())))};
+	uint64_t seen{};
+
+	for (uint64_t i{}; i < histogramBuckets; ++i)
+	{
+		seen += buckets[i];
+
+		if (seen >= rank and seen != 0)
+		{
+			return i == histogramBuckets - 1 ? UINT64_MAX : (uint64_t{1} << i) - 1;
+		}
+	}
+
+	return 0;
+}
+
+Metrics::Snapshot Metrics::snapshot()
+{
+	auto& threads{registry()};
+	std::lock_guard lock{threads.mutex};
+
+	auto snapshot{threads.finished};
+
+	for (const auto* counters : threads.threads)
+	{
+		accumulate(snapshot, *counters);
+	}
+
+	std::ranges::sort(snapshot.unsupportedLayers);
+
+	return snapshot;
+}
+
+void Metrics::reset() noexcept
+{
+	auto& threads{registry()};
+	std::lock_guard lock{threads.mutex};
+
+	threads.finished = Snapshot{};
+
+	for (auto* counters : threads.threads)
+	{
+		// the owning thread may record concurrently, each counter is zeroed on its own
+		counters->reads = 0;
+		counters->readBytes = 0;
+		counters->stallTime = 0;
+
+		for (uint64_t i{}; i < histogramBuckets; ++i)
+		{
+			counters->readLatency[i] = 0;
+			counters->readSize[i] = 0;
+		}
+
+		for (auto& failures : counters->parseFailures)
+		{
+			failures = 0;
+		}
+
+		for (auto& layers : counters->unsupportedLayers)
+		{
+			layers = 0;
+		}
+
+		counters->otherUnsupportedLayers = 0;
+	}
+}
+
+void Metrics::recordRead(std::chrono::nanoseconds latency, uint64_t size) noexcept
+{
+	auto& counters{local()};
+
+	add(counters.reads, 1);
+	add(counters.readBytes, size);
+	add(counters.readLatency[bucket(static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0)))], 1);
+	add(counters.readSize[bucket(size)], 1);
+}
+
+void Metrics::recordStall(std::chrono::nanoseconds time) noexcept
+{
+	add(local().stallTime, static_cast<uint64_t>(std::max<int64_t>(time.count(), 0)));
+}
+
+void Metrics::recordParseFailure(ParseFailure reason) noexcept
+{
+	add(local().parseFailures[static_cast<uint64_t>(reason)], 1);
+}
+
+void Metrics::recordUnsupportedLayer(uint32_t type) noexcept
+{
+	auto& counters{local()};
+
+	// slots are only claimed by the owning thread
+	for (uint64_t i{}; i < unsupportedLayerTypes; ++i)
+	{
+		auto slotType{counters.unsupportedLayerTypes[i].load(std::memory_order_relaxed)};
+
+		if (slotType == 0)
+		{
+			slotType = type + 1;
+			counters.unsupportedLayerTypes[i].store(slotType, std::memory_order_relaxed);
+		}
+
+		if (slotType == type + 1)
+		{
+			add(counters.unsupportedLayers[i], 1);
+			return;
+		}
+	}
+
+	add(counters.otherUnsupportedLayers, 1);
+}
+} // namespace pcap
@@ -0,0 +1,124 @@
+#ifndef PCAP_UTILS_METRICS_HPP
+#define PCAP_UTILS_METRICS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pcap
+{
+/**
+ * @brief Process-wide reader metrics.
+ * 
+ * Every thread records into its own counters, which are only summed up when a snapshot is taken, so recording
+ * never contends between threads. Reads are the large reads of batches, read-ahead blocks and compressed input,
+ * stalls are the time a reader waits for a read-ahead or decompressed block.
+ */
+class Metrics final
+{
+public:
+	// bucket `i` counts the values in [2^(i - 1), 2^i)
+	static constexpr uint64_t histogramBuckets{64};
+	// distinct unsupported layer types counted per thread, the others only go to `otherUnsupportedLayers`
+	static constexpr uint64_t unsupportedLayerTypes{16};
+
+	enum class ParseFailure : uint8_t
+	{
+		// the packet has a link layer the library does not parse
+		unsupportedLayer,
+		// the packet ends inside a network layer
+		truncatedLayer
+	};
+
+	static constexpr uint64_t parseFailureReasons{2};
+
+	struct Histogram
+	{
+		std::array<uint64_t, histogramBuckets> buckets;
+
+		/**
+		 * @brief Returns the number of recorded values.
+		 * 
+		 * @return Number of values
+		 */
+		[[nodiscard]] uint64_t count() const noexcept;
+
+		/**
+		 * @brief Returns an upper bound of the percentile, e.g. `percentile(0.99)`.
+		 * 
+		 * @param fraction Fraction of values in [0, 1]
+		 * 
+		 * @return Upper bound of the bucket holding the percentile
+		 */
+		[[nodiscard]] uint64_t percentile(double fraction) const noexcept;
+	};
+
+	struct Snapshot
+	{
+		uint64_t reads;
+		uint64_t readBytes;
+		std::chrono::nanoseconds stallTime;
+		// nanoseconds per read
+		Histogram readLatency;
+		// bytes per read
+		Histogram readSize;
+		std::array<uint64_t, parseFailureReasons> parseFailures;
+		// (type, count) sorted by type, where parsing reached a link layer type, an ethertype (at least 0x0600) or
+		// an IP protocol the library does not decode
+		std::vector<std::pair<uint32_t, uint64_t>> unsupportedLayers;
+		uint64_t otherUnsupportedLayers;
+	};
+
+	/**
+	 * @brief Sums up the counters of all threads, including finished ones.
+	 * 
+	 * @return Metrics snapshot
+	 */
+	[[nodiscard]] static Snapshot snapshot();
+
+	/**
+	 * @brief Zeroes the counters of all threads.
+	 */
+	static void reset() noexcept;
+
+	/**
+	 * @brief Records a read in the counters of the calling thread.
+	 * 
+	 * @param latency Read duration
+	 * @param size Read bytes
+	 */
+	static void recordRead(std::chrono::nanoseconds latency, uint64_t size) noexcept;
+
+	/**
+	 * @brief Records the time the calling thread waited for data.
+	 * 
+	 * @param time Wait duration
+	 */
+	static void recordStall(std::chrono::nanoseconds time) noexcept;
+
+	/**
+	 * @brief Records a packet that could not be parsed.
+	 * 
+	 * @param reason Failure reason
+	 */
+	static void recordParseFailure(ParseFailure reason) noexcept;
+
+	/**
+	 * @brief Records a link layer type, ethertype or IP protocol the library does not decode.
+	 * 
+	 * @param type Layer type
+	 */
+	static void recordUnsupportedLayer(uint32_t type) noexcept;
+};
+} // namespace pcap
+
+// the library records metrics through `PCAP_METRICS()` only: without `PCAP_WITH_METRICS` the statements are not compiled
+#ifdef PCAP_WITH_METRICS
+#define PCAP_METRICS(...) __VA_ARGS__
+#else
+#define PCAP_METRICS(...)
+#endif
+
+#endif // PCAP_UTILS_METRICS_HPP
@@ -0,0 +1,344 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include "read_ahead.hpp"
+#include "metrics.hpp"
+
+namespace pcap
+{
+namespace
+{
+int64_t readFully(int descriptor, uint8_t* data, uint64_t size, uint64_t offset) noexcept
+{
+	uint64_t readBytes{};
+
+	while (readBytes < size)
+	{
+		PCAP_METRICS(const auto start{std::chrono::steady_clock::now()});
+		const auto result{::pread(descriptor, data + readBytes, size - readBytes, static_cast<off_t>(offset + readBytes))};
+		PCAP_METRICS(Metrics::recordRead(std::chrono::steady_clock::now() - start, std::max<int64_t>(result, 0)));
+
+		if (result == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return -errno;
+		}
+
+		if (result == 0)
+		{
+			break;
+		}
+
+		readBytes += result;
+	}
+
+	return static_cast<int64_t>(readBytes);
+}
+} // namespace
+
+ReadAhead::ReadAhead() noexcept
+	: bufferSize_{}
+	, fileSize_{}
+	, nextOffset_{}
+	, released_{}
+	, submitted_{}
+	, descriptor_{-1}
+{
+}
+
+ReadAhead::~ReadAhead()
+{
+	close();
+}
+
+bool ReadAhead::open(const std::string& fileName, const Options& options)
+{
+	close();
+
+	descriptor_ = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (descriptor_ == -1)
+	{
+		return false;
+	}
+
+	struct stat status{};
+
+	if (::fstat(descriptor_, &status) == -1)
+	{
+		close();
+		return false;
+	}
+
+	::posix_fadvise(descriptor_, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	fileSize_ = static_cast<uint64_t>(status.st_size);
+	bufferSize_ = std::max<uint64_t>(options.bufferSize, 4096);
+
+	// at least two buffers: one being consumed, one being read
+	blocks_.resize(std::max<uint32_t>(options.queueDepth, 2));
+
+	for (auto& block : blocks_)
+	{
+		block.data = std::make_unique_for_overwrite<uint8_t[]>(bufferSize_);
+	}
+
+	if (not options.ioUring or not ring_.open(static_cast<uint32_t>(blocks_.size())))
+	{
+		worker_ = std::jthread{[this](std::stop_token token) { work(token); }};
+	}
+
+	seek(0);
+
+	return true;
+}
+
+bool ReadAhead::isOpen() const noexcept
+{
+	return descriptor_ != -1;
+}
+
+void ReadAhead::close()
+{
+	// buffers must not be released while the kernel or the worker may still write into them
+	drain();
+
+	if (worker_.joinable())
+	{
+		{
+			std::lock_guard lock{mutex_};
+			worker_.request_stop();
+		}
+
+		requested_.notify_all();
+		worker_.join();
+	}
+
+	ring_.close();
+
+	if (descriptor_ != -1)
+	{
+		::close(descriptor_);
+	}
+
+	blocks_.clear();
+	requests_.clear();
+	fileSize_ = 0;
+	nextOffset_ = 0;
+	released_ = 0;
+	submitted_ = 0;
+	descriptor_ = -1;
+	reset(0);
+}
+
+uint64_t ReadAhead::size() const noexcept
+{
+	return fileSize_;
+}
+
+bool ReadAhead::usesIoUring() const noexcept
+{
+	return ring_.isOpen();
+}
+
+uint64_t ReadAhead::skip(uint64_t size)
+{
+	const auto target{std::min(offset() + size, fileSize_)};
+
+	if (target > nextOffset_)
+	{
+		// the skipped range has not been requested yet: do not read it at all
+		const auto skipped{target - offset()};
+		seek(target);
+
+		return skipped;
+	}
+
+	return BlockSource::skip(size);
+}
+
+std::span<const uint8_t> ReadAhead::block(uint64_t sequence)
+{
+	if (sequence >= submitted_)
+	{
+		return {};
+	}
+
+	auto& block{blocks_[sequence % blocks_.size()]};
+	complete(block);
+
+	if (block.result >= 0 and static_cast<uint64_t>(block.result) < block.size)
+	{
+		// short reads are legal: finish the block synchronously
+		const auto result{readFully(descriptor_, block.data.get() + block.result, block.size - block.result, block.offset + block.result)};
+		block.result = result < 0 ? result : block.result + result;
+	}
+
+	if (block.result < 0)
+	{
+		throw std::runtime_error(std::format("pcap::ReadAhead [exception]: cannot read file: {}", std::strerror(-block.result)));
+	}
+
+	// the file was truncated while reading
+	block.size = block.result;
+
+	return {block.data.get(), static_cast<size_t>(block.size)};
+}
+
+void ReadAhead::release(uint64_t sequence)
+{
+	released_ = sequence + 1;
+	submit();
+}
+
+uint64_t ReadAhead::restart(uint64_t offset)
+{
+	drain();
+
+	const auto start{std::min(offset, fileSize_)};
+
+	nextOffset_ = start;
+	released_ = 0;
+	submitted_ = 0;
+
+	for (uint64_t i{}; i < blocks_.size(); ++i)
+	{
+		submit();
+	}
+
+	return start;
+}
+
+void ReadAhead::complete(Block& block)
+{
+	if (ring_.isOpen())
+	{
+		if (block.ready)
+		{
+			return;
+		}
+
+		PCAP_METRICS(const auto start{std::chrono::steady_clock::now()});
+		IoUring::Completion completion{};
+
+		while (not block.ready)
+		{
+			if (not ring_.wait(completion))
+			{
+				throw std::runtime_error(std::format("pcap::ReadAhead [exception]: io_uring wait failed: {}", std::strerror(errno)));
+			}
+
+			auto& completed{blocks_[completion.userData]};
+			completed.result = completion.result;
+			completed.ready = true;
+
+			PCAP_METRICS(Metrics::recordRead(std::chrono::steady_clock::now() - completed.submitted, std::max(completion.result, 0)));
+		}
+
+		PCAP_METRICS(Metrics::recordStall(std::chrono::steady_clock::now() - start));
+		return;
+	}
+
+	std::unique_lock lock{mutex_};
+
+	if (block.ready)
+	{
+		return;
+	}
+
+	PCAP_METRICS(const auto start{std::chrono::steady_clock::now()});
+	completed_.wait(lock, [&block] { return block.ready; });
+	PCAP_METRICS(Metrics::recordStall(std::chrono::steady_clock::now() - start));
+}
+
+void ReadAhead::submit()
+{
+	if (nextOffset_ >= fileSize_ or submitted_ - released_ == blocks_.size())
+	{
+		return;
+	}
+
+	const auto index{submitted_ % blocks_.size()};
+	auto& block{blocks_[index]};
+
+	block.offset = nextOffset_;
+	block.size = std::min(bufferSize_, fileSize_ - nextOffset_);
+	block.result = 0;
+	block.ready = false;
+
+	nextOffset_ += block.size;
+	++submitted_;
+
+	if (ring_.isOpen())
+	{
+		block.submitted = std::chrono::steady_clock::now();
+
+		if (not ring_.read(descriptor_, block.data.get(), static_cast<uint32_t>(block.size), block.offset, index))
+		{
+			block.result = readFully(descriptor_, block.data.get(), block.size, block.offset);
+			block.ready = true;
+		}
+
+		return;
+	}
+
+	{
+		std::lock_guard lock{mutex_};
+		requests_.push_back(index);
+	}
+
+	requested_.notify_one();
+}
+
+void ReadAhead::drain()
+{
+	for (auto sequence{released_}; sequence < submitted_; ++sequence)
+	{
+		complete(blocks_[sequence % blocks_.size()]);
+	}
+}
+
+void ReadAhead::work(std::stop_token token)
+{
+	while (true)
+	{
+		uint64_t index{};
+
+		{
+			std::unique_lock lock{mutex_};
+			requested_.wait(lock, [this, &token] { return not requests_.empty() or token.stop_requested(); });
+
+			if (token.stop_requested())
+			{
+				return;
+			}
+
+			index = requests_.front();
+			requests_.pop_front();
+		}
+
+		auto& block{blocks_[index]};
+		const auto result{readFully(descriptor_, block.data.get(), block.size, block.offset)};
+
+		{
+			std::lock_guard lock{mutex_};
+			block.result = result;
+			block.ready = true;
+		}
+
+		completed_.notify_all();
+	}
+}
+} // namespace pcap
@@ -0,0 +1,123 @@
+#ifndef PCAP_UTILS_READ_AHEAD_HPP
+#define PCAP_UTILS_READ_AHEAD_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "block_source.hpp"
+#include "io_uring.hpp"
+
+namespace pcap
+{
+/**
+ * @brief Sequential file reader keeping up to `queueDepth` large reads in flight, so disk latency overlaps with
+ * packet processing. Reads go through io_uring when the kernel supports it, otherwise through `pread()` on a
+ * background thread.
+ */
+class ReadAhead final : public BlockSource
+{
+public:
+	struct Options
+	{
+		uint32_t queueDepth{4};
+		uint64_t bufferSize{1024 * 1024};
+		bool ioUring{true};
+	};
+
+	ReadAhead() noexcept;
+	ReadAhead(const ReadAhead&) = delete;
+	ReadAhead(ReadAhead&&) = delete;
+	ReadAhead& operator=(const ReadAhead&) = delete;
+	ReadAhead& operator=(ReadAhead&&) = delete;
+	~ReadAhead() override;
+
+	/**
+	 * @brief Opens the file and starts reading ahead from its beginning.
+	 * 
+	 * @param fileName File name
+	 * @param options Read-ahead options
+	 * 
+	 * @return `True` if the file was successfully opened, otherwise - `false`
+	 */
+	[[nodiscard]] bool open(const std::string& fileName, const Options& options);
+
+	/**
+	 * @brief Checks whether the file is opened.
+	 * 
+	 * @return `True` if the file is opened, otherwise - `false`
+	 */
+	[[nodiscard]] bool isOpen() const noexcept;
+
+	/**
+	 * @brief Stops reading ahead and closes the file.
+	 */
+	void close();
+
+	/**
+	 * @brief Returns the file size.
+	 * 
+	 * @return File size
+	 */
+	[[nodiscard]] uint64_t size() const noexcept;
+
+	/**
+	 * @brief Checks whether reads go through io_uring.
+	 * 
+	 * @return `True` if reads go through io_uring, otherwise - `false`
+	 */
+	[[nodiscard]] bool usesIoUring() const noexcept;
+
+	/**
+	 * @brief Skips the next bytes of the file, restarting reads past the skipped range when it is not requested yet.
+	 * 
+	 * @param size Number of bytes
+	 * 
+	 * @return Number of bytes skipped, less than `size` only at the end of file
+	 */
+	uint64_t skip(uint64_t size) override;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<uint8_t[]> data;
+		uint64_t offset;
+		uint64_t size;
+		int64_t result;
+		bool ready;
+		// io_uring reads only, for the read latency metrics
+		std::chrono::steady_clock::time_point submitted;
+	};
+
+	std::span<const uint8_t> block(uint64_t sequence) override;
+	void release(uint64_t sequence) override;
+	uint64_t restart(uint64_t offset) override;
+
+	void complete(Block& block);
+	void submit();
+	void drain();
+	void work(std::stop_token token);
+
+	std::vector<Block> blocks_;
+	IoUring ring_;
+	std::jthread worker_;
+	std::mutex mutex_;
+	std::condition_variable requested_;
+	std::condition_variable completed_;
+	std::deque<uint64_t> requests_;
+	uint64_t bufferSize_;
+	uint64_t fileSize_;
+	uint64_t nextOffset_;
+	uint64_t released_;
+	uint64_t submitted_;
+	int descriptor_;
+};
+} // namespace pcap
+
+#endif // PCAP_UTILS_READ_AHEAD_HPP
@@ -0,0 +1,235 @@
+#ifndef PCAP_UTILS_SMALL_VECTOR_HPP
+#define PCAP_UTILS_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace pcap
+{
+/**
+ * @brief Vector of trivially copyable elements keeping the first `N` of them inline: it only touches the heap
+ * when it grows past `N`, and `clear()` keeps the capacity, so a reused vector stops allocating after warm-up.
+ */
+template <typename T, uint64_t N>
+class SmallVector final
+{
+	static_assert(std::is_trivially_copyable_v<T>, "pcap::SmallVector: elements must be trivially copyable");
+	static_assert(N > 0, "pcap::SmallVector: inline capacity must not be zero");
+
+public:
+	SmallVector() noexcept;
+	SmallVector(const SmallVector& vector);
+	SmallVector(SmallVector&& vector) noexcept;
+	SmallVector& operator=(const SmallVector& vector);
+	SmallVector& operator=(SmallVector&& vector) noexcept;
+
+	void push_back(const T& value);
+	void reserve(uint64_t capacity);
+	void clear() noexcept;
+
+	[[nodiscard]] uint64_t size() const noexcept;
+	[[nodiscard]] uint64_t capacity() const noexcept;
+	[[nodiscard]] bool empty() const noexcept;
+
+	[[nodiscard]] T* data() noexcept;
+	[[nodiscard]] const T* data() const noexcept;
+	[[nodiscard]] T* begin() noexcept;
+	[[nodiscard]] const T* begin() const noexcept;
+	[[nodiscard]] T* end() noexcept;
+	[[nodiscard]] const T* end() const noexcept;
+	[[nodiscard]] T& front() noexcept;
+	[[nodiscard]] const T& front() const noexcept;
+	[[nodiscard]] T& back() noexcept;
+	[[nodiscard]] const T& back() const noexcept;
+	[[nodiscard]] T& operator[](uint64_t index) noexcept;
+	[[nodiscard]] const T& operator[](uint64_t index) const noexcept;
+
+private:
+	std::array<T, N> inline_;
+	std::unique_ptr<T[]> heap_;
+	uint64_t size_;
+	uint64_t capacity_;
+};
+
+template <typename T, uint64_t N>
+SmallVector<T, N>::SmallVector() noexcept : inline_{}, heap_{}, size_{}, capacity_{N}
+{
+}
+
+template <typename T, uint64_t N>
+SmallVector<T, N>::SmallVector(const SmallVector& vector) : SmallVector{}
+{
+	*this = vector;
+}
+
+template <typename T, uint64_t N>
+SmallVector<T, N>::SmallVector(SmallVector&& vector) noexcept : SmallVector{}
+{
+	*this = std::move(vector);
+}
+
+template <typename T, uint64_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& vector)
+{
+	if (this != &vector)
+	{
+		clear();
+		reserve(vector.size_);
+		std::copy_n(vector.data(), vector.size_, data());
+		size_ = vector.size_;
+	}
+
+	return *this;
+}
+
+template <typename T, uint64_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(SmallVector&& vector) noexcept
+{
+	if (this != &vector)
+	{
+		if (vector.heap_)
+		{
+			heap_ = std::move(vector.heap_);
+			capacity_ = vector.capacity_;
+		}
+		else
+		{
+			// the own heap block, if any, is kept for reuse
+			std::copy_n(vector.inline_.data(), vector.size_, data());
+		}
+
+		size_ = vector.size_;
+		vector.size_ = 0;
+		vector.capacity_ = N;
+	}
+
+	return *this;
+}
+
+template <typename T, uint64_t N>
+void SmallVector<T, N>::push_back(const T& value)
+{
+	if (size_ == capacity_)
+	{
+		reserve(capacity_ * 2);
+	}
+
+	data()[size_++] = value;
+}
+
+template <typename T, uint64_t N>
+void SmallVector<T, N>::reserve(uint64_t capacity)
+{
+	if (capacity <= capacity_)
+	{
+		return;
+	}
+
+	auto heap{std::make_unique_for_overwrite<T[]>(capacity)};
+	std::memcpy(heap.get(), data(), size_ * sizeof(T));
+	heap_ = std::move(heap);
+	capacity_ = capacity;
+}
+
+template <typename T, uint64_t N>
+void SmallVector<T, N>::clear() noexcept
+{
+	size_ = 0;
+}
+
+template <typename T, uint64_t N>
+uint64_t SmallVector<T, N>::size() const noexcept
+{
+	return size_;
+}
+
+template <typename T, uint64_t N>
+uint64_t SmallVector<T, N>::capacity() const noexcept
+{
+	return capacity_;
+}
+
+template <typename T, uint64_t N>
+bool SmallVector<T, N>::empty() const noexcept
+{
+	return size_ == 0;
+}
+
+template <typename T, uint64_t N>
+T* SmallVector<T, N>::data() noexcept
+{
+	return heap_ ? heap_.get() : inline_.data();
+}
+
+template <typename T, uint64_t N>
+const T* SmallVector<T, N>::data() const noexcept
+{
+	return heap_ ? heap_.get() : inline_.data();
+}
+
+template <typename T, uint64_t N>
+T* SmallVector<T, N>::begin() noexcept
+{
+	return data();
+}
+
+template <typename T, uint64_t N>
+const T* SmallVector<T, N>::begin() const noexcept
+{
+	return data();
+}
+
+template <typename T, uint64_t N>
+T* SmallVector<T, N>::end() noexcept
+{
+	return data() + size_;
+}
+
+template <typename T, uint64_t N>
+const T* SmallVector<T, N>::end() const noexcept
+{
+	return data() + size_;
+}
+
+template <typename T, uint64_t N>
+T& SmallVector<T, N>::front() noexcept
+{
+	return data()[0];
+}
+
+template <typename T, uint64_t N>
+const T& SmallVector<T, N>::front() const noexcept
+{
+	return data()[0];
+}
+
+template <typename T, uint64_t N>
+T& SmallVector<T, N>::back() noexcept
+{
+	return data()[size_ - 1];
+}
+
+template <typename T, uint64_t N>
+const T& SmallVector<T, N>::back() const noexcept
+{
+	return data()[size_ - 1];
+}
+
+template <typename T, uint64_t N>
+T& SmallVector<T, N>::operator[](uint64_t index) noexcept
+{
+	return data()[index];
+}
+
+template <typename T, uint64_t N>
+const T& SmallVector<T, N>::operator[](uint64_t index) const noexcept
+{
+	return data()[index];
+}
+} // namespace pcap
+
+#endif // PCAP_UTILS_SMALL_VECTOR_HPP
@@ -0,0 +1,115 @@
+#ifndef PCAP_UTILS_SPSC_RING_HPP
+#define PCAP_UTILS_SPSC_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace pcap
+{
+/**
+ * @brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * 
+ * Each side keeps a cached copy of the other side's index and only reloads it when the ring looks full or empty,
+ * so the indices' cache lines move between cores once per many items instead of once per item.
+ */
+template <typename T>
+class SpscRing final
+{
+public:
+	explicit SpscRing(uint64_t capacity);
+	SpscRing(const SpscRing&) = delete;
+	SpscRing(SpscRing&&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+	SpscRing& operator=(SpscRing&&) = delete;
+
+	/**
+	 * @brief Appends an item, called by the producer only.
+	 * 
+	 * @param item Item
+	 * 
+	 * @return `True` if the item was appended, `false` if the ring is full
+	 */
+	[[nodiscard]] bool push(const T& item) noexcept;
+
+	/**
+	 * @brief Removes the oldest item, called by the consumer only.
+	 * 
+	 * @param item Item
+	 * 
+	 * @return `True` if an item was removed, `false` if the ring is empty
+	 */
+	[[nodiscard]] bool pop(T& item) noexcept;
+
+private:
+	static constexpr uint64_t cacheLineSize{64};
+
+	std::vector<T> items_;
+	uint64_t mask_;
+
+	// consumer side
+	alignas(cacheLineSize) std::atomic<uint64_t> head_;
+	uint64_t cachedTail_;
+
+	// producer side
+	alignas(cacheLineSize) std::atomic<uint64_t> tail_;
+	uint64_t cachedHead_;
+};
+
+template <typename T>
+SpscRing<T>::SpscRing(uint64_t capacity)
+	: items_(std::bit_ceil(std::max<uint64_t>(capacity, 2)))
+	, mask_{items_.size() - 1}
+	, head_{}
+	, cachedTail_{}
+	, tail_{}
+	, cachedHead_{}
+{
+}
+
+template <typename T>
+bool SpscRing<T>::push(const T& item) noexcept
+{
+	const auto tail{tail_.load(std::memory_order_relaxed)};
+
+	if (tail - cachedHead_ == items_.size())
+	{
+		cachedHead_ = head_.load(std::memory_order_acquire);
+
+		if (tail - cachedHead_ == items_.size())
+		{
+			return false;
+		}
+	}
+
+	items_[tail & mask_] = item;
+	tail_.store(tail + 1, std::memory_order_release);
+
+	return true;
+}
+
+template <typename T>
+bool SpscRing<T>::pop(T& item) noexcept
+{
+	const auto head{head_.load(std::memory_order_relaxed)};
+
+	if (head == cachedTail_)
+	{
+		cachedTail_ = tail_.load(std::memory_order_acquire);
+
+		if (head == cachedTail_)
+		{
+			return false;
+		}
+	}
+
+	item = items_[head & mask_];
+	head_.store(head + 1, std::memory_order_release);
+
+	return true;
+}
+} // namespace pcap
+
+#endif // PCAP_UTILS_SPSC_RING_HPP
@@ -0,0 +1,169 @@
+#include <unistd.h>
+
+#include <bit>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "pcap/file_reader/file_reader.hpp"
+#include "pcap/packet/packet_pool.hpp"
+#include "tools/common/allocation_counter.hpp"
+
+// reads, owns, parses and queues every packet of a capture through a `PacketPool`, once the pool and the packets
+// have grown the measured pass must not allocate
+
+namespace
+{
+constexpr uint32_t magicNumberMicroseconds{0xa1b2c3d4};
+constexpr uint32_t linkLayerEthernet{1};
+constexpr uint64_t packets{4096};
+// packets in flight, the rest of the pool stays free
+constexpr uint64_t queueDepth{64};
+constexpr uint64_t warmUpPasses{2};
+
+template <typename T>
+void append(std::vector<uint8_t>& data, T value)
+{
+	const auto* bytes{reinterpret_cast<const uint8_t*>(&value)};
+	data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+
+template <typename T>
+T networkOrder(T value) noexcept
+{
+	return std::endian::native == std::endian::big ? value : std::byteswap(value);
+}
+
+// Ethernet, IPv4 and UDP frames of varying sizes, so packets are reused for larger ones than they held before
+void generate(const std::filesystem::path& fileName)
+{
+	std::vector<uint8_t> data;
+
+	append(data, pcap::FileReader::FileHeader{magicNumberMicroseconds, 2, 4, 0, 0, 65535, linkLayerEthernet});
+
+	for (uint64_t i{}; i < packets; ++i)
+	{
+		const auto payloadSize{static_cast<uint16_t>(18 + i * 97 % 1400)};
+		const auto frameSize{static_cast<uint32_t>(14 + 20 + 8 + payloadSize)};
+		const uint8_t ethernet[]{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0x08, 0x00};
+
+		append(data, pcap::FileReader::PacketHeader{1'700'000'000, static_cast<uint32_t>(i), frameSize, frameSize});
+		data.insert(data.end(), std::begin(ethernet), std::end(ethernet));
+
+		append<uint8_t>(data, 0x45);
+		append<uint8_t>(data, 0);
+		append(data, networkOrder(static_cast<uint16_t>(20 + 8 + payloadSize)));
+		append(data, networkOrder(static_cast<uint16_t>(i)));
+		append<uint16_t>(data, 0);
+		append<uint8_t>(data, 64);
+		append<uint8_t>(data, 17);
+		append<uint16_t>(data, 0);
+		append(data, networkOrder(static_cast<uint32_t>(0x0a000000 + i % 256)));
+		append(data, networkOrder<uint32_t>(0xc0a80001));
+
+		append(data, networkOrder(static_cast<uint16_t>(1024 + i % 256)));
+		append(data, networkOrder<uint16_t>(5000));
+		append(data, networkOrder(static_cast<uint16_t>(8 + payloadSize)));
+		append<uint16_t>(data, 0);
+
+		data.insert(data.end(), payloadSize, static_cast<uint8_t>(i));
+	}
+
+	std::ofstream file{fileName, std::ios::binary | std::ios::trunc};
+
+	if (not file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())))
+	{
+		throw std::runtime_error(std::format("cannot write '{}'", fileName.string()));
+	}
+}
+
+// one pass over the capture: a packet is released once `queueDepth` newer packets are queued behind it
+void pass(pcap::FileReader& reader, pcap::PacketPool& pool, std::vector<pcap::PacketPool::Handle>& queue)
+{
+	if (not reader.seek(0))
+	{
+		throw std::runtime_error("cannot rewind the capture");
+	}
+
+	for (uint64_t i{}; true; ++i)
+	{
+		auto handle{pool.acquire()};
+
+		if (not reader.readNextPacket(*handle))
+		{
+			break;
+		}
+
+		handle->own();
+
+		if (not handle->parse())
+		{
+			throw std::runtime_error(std::format("cannot parse packet {}", i));
+		}
+
+		auto& slot{queue[i % queue.size()]};
+		slot.release();
+		slot = std::move(handle);
+	}
+
+	for (auto& slot : queue)
+	{
+		slot.release();
+	}
+}
+
+// allocations of the measured pass
+uint64_t measure(const std::filesystem::path& fileName, pcap::FileReader::Mode mode)
+{
+	pcap::FileReader reader{fileName.string(), pcap::FileReader::Options{mode}};
+	pcap::PacketPool pool{queueDepth + 1};
+	std::vector<pcap::PacketPool::Handle> queue(queueDepth);
+
+	for (uint64_t i{}; i < warmUpPasses; ++i)
+	{
+		pass(reader, pool, queue);
+	}
+
+	const auto allocationsBefore{pcap::tools::allocations()};
+	pass(reader, pool, queue);
+
+	return pcap::tools::allocations() - allocationsBefore;
+}
+} // namespace
+
+int main()
+{
+	const auto fileName{std::filesystem::temp_directory_path() / std::format("packet_pool_allocations-{}.pcap", ::getpid())};
+	auto failed{false};
+
+	try
+	{
+		generate(fileName);
+
+		for (const auto& [mode, name] : {std::pair{pcap::FileReader::Mode::stream, "stream"}, std::pair{pcap::FileReader::Mode::memoryMapped, "memory-mapped"}})
+		{
+			const auto allocations{measure(fileName, mode)};
+
+			std::cout << std::format("{}: {} allocations after warm-up\n", name, allocations);
+			failed = failed or allocations != 0;
+		}
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << '\n';
+		failed = true;
+	}
+
+	std::error_code error;
+	std::filesystem::remove(fileName, error);
+
+	return failed ? 1 : 0;
+}
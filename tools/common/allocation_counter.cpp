@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.hpp"
+
+namespace
+{
+// every allocation of the process goes through the replaced `operator new` below
+std::atomic<uint64_t> allocationCount{};
+
+void* allocate(std::size_t size, std::size_t alignment = 0)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	size = std::max<std::size_t>(size, 1);
+	auto* memory{alignment == 0 ? std::malloc(size) : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)};
+
+	if (not memory)
+	{
+		throw std::bad_alloc{};
+	}
+
+	return memory;
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace pcap::tools
+{
+uint64_t allocations() noexcept
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+} // namespace pcap::tools
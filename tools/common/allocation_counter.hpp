@@ -0,0 +1,19 @@
+#ifndef PCAP_TOOLS_ALLOCATION_COUNTER_HPP
+#define PCAP_TOOLS_ALLOCATION_COUNTER_HPP
+
+#include <cstdint>
+
+namespace pcap::tools
+{
+/**
+ * @brief Returns the number of allocations made by the process so far.
+ * 
+ * Linking `allocation_counter.cpp` replaces the global `operator new` with a counting one, the count includes
+ * the allocations of every thread and of the library.
+ * 
+ * @return Number of allocations
+ */
+[[nodiscard]] uint64_t allocations() noexcept;
+} // namespace pcap::tools
+
+#endif // PCAP_TOOLS_ALLOCATION_COUNTER_HPP
@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pcap/file_reader/file_reader.hpp"
+#include "pcap/network_layer/deserializer.hpp"
+#include "pcap/network_layer/utils.hpp"
+#include "pcap/network_layer/views.hpp"
+#include "pcap/packet/packet.hpp"
+#include "tools/common/allocation_counter.hpp"
+
+namespace
+{
+constexpr uint32_t magicNumberMicroseconds{0xa1b2c3d4};
+constexpr uint32_t magicNumberNanoseconds{0xa1b23c4d};
+constexpr uint32_t linkLayerEthernet{1};
+constexpr uint64_t headersSize{14 + 20 + 8};
+constexpr uint64_t parseSamplePackets{4096};
+constexpr uint32_t flows{1024};
+
+struct Capture
+{
+	std::string name;
+	std::endian endian;
+	bool nanoseconds;
+	uint32_t frameSize;
+};
+
+// small frames stress per-packet overhead, jumbo frames stress copying, both byte orders and timestamp precisions are covered
+const std::vector<Capture> captures{{"small-le-us", std::endian::little, false, 64},
+				    {"small-be-ns", std::endian::big, true, 64},
+				    {"jumbo-le-ns", std::endian::little, true, 9000},
+				    {"jumbo-be-us", std::endian::big, false, 9000}};
+
+struct Arguments
+{
+	std::filesystem::path directory{std::filesystem::temp_directory_path()};
+	// bytes of every generated capture
+	uint64_t captureSize{64 * 1024 * 1024};
+	std::chrono::milliseconds minTime{500};
+	std::string filter;
+};
+
+// work done by a single iteration of a benchmark
+struct Work
+{
+	uint64_t packets;
+	uint64_t bytes;
+};
+
+struct Result
+{
+	uint64_t iterations;
+	std::chrono::nanoseconds time;
+	Work work;
+	uint64_t allocations;
+};
+
+// keeps the compiler from dropping the measured work, like `benchmark::DoNotOptimize()`
+volatile uint64_t sink{};
+
+void usage()
+{
+	std::cerr << "usage: pcap_bench [--directory DIR] [--size MB] [--min-time MS] [--filter TEXT]\n"
+		     "  --directory DIR  where the synthetic captures are generated, the temporary directory by default\n"
+		     "  --size MB        size of every synthetic capture, 64 by default\n"
+		     "  --min-time MS    minimal measured time of every benchmark, 500 by default\n"
+		     "  --filter TEXT    only benchmarks whose names contain the text are run\n";
+}
+
+uint64_t number(std::string_view text)
+{
+	uint64_t value{};
+	const auto [end, error]{std::from_chars(text.data(), text.data() + text.size(), value)};
+
+	if (error != std::errc{} or end != text.data() + text.size())
+	{
+		throw std::invalid_argument(std::format("pcap_bench: '{}' is not a number", text));
+	}
+
+	return value;
+}
+
+std::optional<Arguments> parseArguments(int argc, char** argv)
+{
+	Arguments arguments{};
+
+	if (argc % 2 == 0)
+	{
+		return std::nullopt;
+	}
+
+	for (auto i{1}; i + 1 < argc; i += 2)
+	{
+		const std::string_view option{argv[i]};
+		const std::string_view value{argv[i + 1]};
+
+		if (option == "--directory")
+		{
+			arguments.directory = value;
+		}
+		else if (option == "--size")
+		{
+			arguments.captureSize = number(value) * 1024 * 1024;
+		}
+		else if (option == "--min-time")
+		{
+			arguments.minTime = std::chrono::milliseconds{number(value)};
+		}
+		else if (option == "--filter")
+		{
+			arguments.filter = value;
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+
+	return arguments;
+}
+
+template <typename T>
+T fileOrder(T value, std::endian endian) noexcept
+{
+	return endian == std::endian::native ? value : std::byteswap(value);
+}
+
+template <typename T>
+void append(std::vector<uint8_t>& data, T value)
+{
+	const auto* bytes{reinterpret_cast<const uint8_t*>(&value)};
+	data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+
+// Ethernet, IPv4 and UDP headers in network byte order followed by a payload, every packet belongs to one of `flows` flows
+void appendFrame(std::vector<uint8_t>& data, uint64_t index, uint32_t frameSize)
+{
+	const auto flow{static_cast<uint32_t>(index % flows)};
+	const auto payloadSize{static_cast<uint16_t>(frameSize - headersSize)};
+	const uint8_t ethernet[]{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0x08, 0x00};
+
+	data.insert(data.end(), std::begin(ethernet), std::end(ethernet));
+
+	append<uint8_t>(data, 0x45);
+	append<uint8_t>(data, 0);
+	append(data, fileOrder<uint16_t>(20 + 8 + payloadSize, std::endian::big));
+	append(data, fileOrder(static_cast<uint16_t>(index), std::endian::big));
+	append<uint16_t>(data, 0);
+	append<uint8_t>(data, 64);
+	append<uint8_t>(data, 17);
+	append<uint16_t>(data, 0);
+	append(data, fileOrder(0x0a000000 + flow, std::endian::big));
+	append(data, fileOrder<uint32_t>(0xc0a80001, std::endian::big));
+
+	append(data, fileOrder(static_cast<uint16_t>(1024 + flow), std::endian::big));
+	append(data, fileOrder<uint16_t>(5000, std::endian::big));
+	append(data, fileOrder<uint16_t>(8 + payloadSize, std::endian::big));
+	append<uint16_t>(data, 0);
+
+	// deterministic payload bytes
+	auto state{static_cast<uint32_t>(index) * 2654435761u + 1};
+
+	for (uint16_t i{}; i < payloadSize; ++i)
+	{
+		state = state * 1664525u + 1013904223u;
+		data.push_back(static_cast<uint8_t>(state >> 24));
+	}
+}
+
+void generate(const std::filesystem::path& fileName, const Capture& capture, uint64_t size)
+{
+	std::ofstream file{fileName, std::ios::binary | std::ios::trunc};
+
+	if (not file)
+	{
+		throw std::runtime_error(std::format("pcap_bench: cannot open '{}'", fileName.string()));
+	}
+
+	std::vector<uint8_t> data;
+
+	append(data, fileOrder(capture.nanoseconds ? magicNumberNanoseconds : magicNumberMicroseconds, capture.endian));
+	append(data, fileOrder<uint16_t>(2, capture.endian));
+	append(data, fileOrder<uint16_t>(4, capture.endian));
+	append<uint32_t>(data, 0);
+	append<uint32_t>(data, 0);
+	append(data, fileOrder<uint32_t>(65535, capture.endian));
+	append(data, fileOrder(linkLayerEthernet, capture.endian));
+
+	const auto packets{std::max<uint64_t>(1, size / (sizeof(pcap::FileReader::PacketHeader) + capture.frameSize))};
+
+	for (uint64_t i{}; i < packets; ++i)
+	{
+		// a packet every 1.5 microseconds from 2023-11-14
+		const auto timestamp{1'700'000'000'000'000'000 + i * 1500};
+		const auto fraction{timestamp % 1'000'000'000};
+
+		append(data, fileOrder(static_cast<uint32_t>(timestamp / 1'000'000'000), capture.endian));
+		append(data, fileOrder(static_cast<uint32_t>(capture.nanoseconds ? fraction : fraction / 1000), capture.endian));
+		append(data, fileOrder(capture.frameSize, capture.endian));
+		append(data, fileOrder(capture.frameSize, capture.endian));
+		appendFrame(data, i, capture.frameSize);
+
+		if (data.size() >= 1024 * 1024)
+		{
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			data.clear();
+		}
+	}
+
+	file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+	if (not file.flush())
+	{
+		throw std::runtime_error(std::format("pcap_bench: cannot write '{}'", fileName.string()));
+	}
+}
+
+// like Google Benchmark: an untimed warm-up iteration, then iterations until the minimal time is reached,
+// allocations are only counted in the measured iterations
+Result measure(const std::function<Work()>& iteration, std::chrono::milliseconds minTime)
+{
+	static_cast<void>(iteration());
+
+	Result result{};
+	const auto allocationsBefore{pcap::tools::allocations()};
+	const auto start{std::chrono::steady_clock::now()};
+
+	do
+	{
+		const auto work{iteration()};
+		result.work.packets += work.packets;
+		result.work.bytes += work.bytes;
+		++result.iterations;
+		result.time = std::chrono::steady_clock::now() - start;
+	} while (result.time < minTime);
+
+	result.allocations = pcap::tools::allocations() - allocationsBefore;
+
+	return result;
+}
+
+void report(std::string_view name, const Result& result)
+{
+	const auto seconds{std::chrono::duration<double>(result.time).count()};
+	const auto packets{static_cast<double>(std::max<uint64_t>(result.work.packets, 1))};
+
+	std::cout << std::format("{:<40} {:>10} {:>12.1f} {:>12.3f}M {:>10.3f}G {:>10.4f}\n",
+				 name,
+				 result.iterations,
+				 seconds * 1e9 / packets,
+				 packets / seconds / 1e6,
+				 static_cast<double>(result.work.bytes) / seconds / 1e9,
+				 static_cast<double>(result.allocations) / packets);
+}
+
+class Runner final
+{
+public:
+	explicit Runner(const Arguments& arguments) : arguments_{arguments}
+	{
+		std::cout << std::format("{:<40} {:>10} {:>12} {:>13} {:>11} {:>10}\n",
+					 "benchmark",
+					 "iterations",
+					 "ns/packet",
+					 "packets/s",
+					 "bytes/s",
+					 "allocs/pkt");
+	}
+
+	void run(std::string_view name, const std::function<Work()>& iteration) const
+	{
+		if (arguments_.filter.empty() or name.find(arguments_.filter) != std::string_view::npos)
+		{
+			report(name, measure(iteration, arguments_.minTime));
+		}
+	}
+
+private:
+	const Arguments& arguments_;
+};
+
+// reading starts over from the first packet, so the reader is opened once and only reading is timed
+Work readFile(pcap::FileReader& reader, pcap::Packet& packet)
+{
+	if (not reader.seek(0))
+	{
+		throw std::runtime_error("pcap_bench: cannot rewind the capture");
+	}
+
+	const auto bytesBefore{reader.readBytes()};
+	uint64_t checksum{};
+
+	while (reader.readNextPacket(packet))
+	{
+		checksum += packet.timestamp();
+	}
+
+	sink = checksum;
+
+	return {reader.readPackets(), reader.readBytes() - bytesBefore};
+}
+
+void readBenchmarks(const Runner& runner, const std::filesystem::path& fileName, const Capture& capture)
+{
+	constexpr std::pair<std::string_view, pcap::FileReader::Mode> modes[]{{"stream", pcap::FileReader::Mode::stream},
+										{"memoryMapped", pcap::FileReader::Mode::memoryMapped},
+										{"readAhead", pcap::FileReader::Mode::readAhead}};
+
+	for (const auto& [modeName, mode] : modes)
+	{
+		const pcap::FileReader::Options options{.mode = mode};
+
+		// opening a capture is reported per open: the file header is read, the file is mapped or read-ahead starts
+		runner.run(std::format("FileReader::open/{}/{}", capture.name, modeName),
+			   [&]
+			   {
+				   const pcap::FileReader reader{fileName.string(), options};
+				   sink = reader.fileSize();
+				   return Work{1, 0};
+			   });
+
+		pcap::FileReader reader{fileName.string(), options};
+		// the packet is reused across iterations as a reading loop would do
+		pcap::Packet packet;
+		runner.run(std::format("readNextPacket/{}/{}", capture.name, modeName), [&] { return readFile(reader, packet); });
+	}
+}
+
+void parseBenchmarks(const Runner& runner, const std::filesystem::path& fileName, const Capture& capture)
+{
+	// a sample of mapped packets is parsed over and over, so the numbers do not include reading
+	pcap::FileReader reader{fileName.string(), pcap::FileReader::Options{.mode = pcap::FileReader::Mode::memoryMapped}};
+	std::vector<pcap::Packet> packets(parseSamplePackets);
+	uint64_t read{};
+	uint64_t bytes{};
+
+	while (read < packets.size() and reader.readNextPacket(packets[read]))
+	{
+		bytes += packets[read++].size();
+	}
+
+	packets.resize(read);
+
+	const Work work{packets.size(), bytes};
+
+	runner.run(std::format("Packet::parse/{}", capture.name),
+		   [&]
+		   {
+			   uint64_t parsed{};
+
+			   for (auto& packet : packets)
+			   {
+				   parsed += packet.parse() ? packet.layers().size() : 0;
+			   }
+
+			   sink = parsed;
+			   return work;
+		   });
+
+	runner.run(std::format("Packet::parse<Ethernet,IPv4,Udp>/{}", capture.name),
+		   [&]
+		   {
+			   uint64_t ports{};
+
+			   for (auto& packet : packets)
+			   {
+				   if (const auto layers{packet.parse<pcap::network_layer::Ethernet, pcap::network_layer::IPv4, pcap::network_layer::Udp>()})
+				   {
+					   ports += std::get<2>(*layers).sourcePort;
+				   }
+			   }
+
+			   sink = ports;
+			   return work;
+		   });
+
+	runner.run(std::format("Packet::locate/{}", capture.name),
+		   [&]
+		   {
+			   uint64_t ports{};
+
+			   for (auto& packet : packets)
+			   {
+				   if (packet.locate())
+				   {
+					   if (const auto udp{packet.layer<pcap::network_layer::UdpView>()})
+					   {
+						   ports += udp->sourcePort();
+					   }
+				   }
+			   }
+
+			   sink = ports;
+			   return work;
+		   });
+
+	runner.run(std::format("Deserializer/{}", capture.name),
+		   [&]
+		   {
+			   constexpr pcap::Deserializer deserializer{};
+			   pcap::network_layer::Ethernet ethernet{};
+			   pcap::network_layer::IPv4 ipv4{};
+			   pcap::network_layer::Udp udp{};
+			   uint64_t types{};
+
+			   for (const auto& packet : packets)
+			   {
+				   auto data{packet.data()};
+				   const auto [ethernetNext, ethernetSize]{deserializer(ethernet, data)};
+				   data = data.subspan(ethernetSize);
+				   const auto [ipv4Next, ipv4Size]{deserializer(ipv4, data)};
+				   data = data.subspan(ipv4Size);
+				   const auto [udpNext, udpSize]{deserializer(udp, data)};
+
+				   types += ethernetNext + ipv4Next + udpNext + udp.sourcePort;
+			   }
+
+			   sink = types;
+			   return work;
+		   });
+
+	runner.run(std::format("deserializeNetworkLayer/{}", capture.name),
+		   [&]
+		   {
+			   uint64_t types{};
+
+			   for (const auto& packet : packets)
+			   {
+				   auto data{packet.data()};
+				   auto type{static_cast<int32_t>(packet.linkLayerType())};
+
+				   while (type > 0)
+				   {
+					   auto layer{pcap::getNetworkLayer(type)};
+
+					   if (not layer)
+					   {
+						   break;
+					   }
+
+					   type = pcap::deserializeNetworkLayer(*layer, data, true);
+					   types += layer->index();
+				   }
+			   }
+
+			   sink = types;
+			   return work;
+		   });
+}
+
+void run(const Arguments& arguments)
+{
+	const Runner runner{arguments};
+
+	for (const auto& capture : captures)
+	{
+		const auto fileName{arguments.directory / std::format("pcap_bench_{}.pcap", capture.name)};
+
+		generate(fileName, capture, arguments.captureSize);
+
+		try
+		{
+			readBenchmarks(runner, fileName, capture);
+
+			// layer parsing does not depend on the file byte order and timestamp precision
+			if (capture.endian == std::endian::little)
+			{
+				parseBenchmarks(runner, fileName, capture);
+			}
+		}
+		catch (...)
+		{
+			std::filesystem::remove(fileName);
+			throw;
+		}
+
+		std::filesystem::remove(fileName);
+	}
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		const auto arguments{parseArguments(argc, argv)};
+
+		if (not arguments)
+		{
+			usage();
+			return 2;
+		}
+
+		run(*arguments);
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}
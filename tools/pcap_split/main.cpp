@@ -0,0 +1,423 @@
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "pcap/file_reader/file_reader.hpp"
+#include "pcap/file_reader/pcapng_decoder.hpp"
+#include "pcap/file_writer/file_writer.hpp"
+#include "pcap/packet/packet_batch.hpp"
+
+namespace
+{
+constexpr uint64_t scanBatchPackets{64 * 1024};
+
+enum class Split : uint8_t
+{
+	packets,
+	time,
+	flows
+};
+
+struct Arguments
+{
+	std::string input;
+	std::string prefix;
+	Split split{Split::packets};
+	// packets per output, window `nanoseconds` or number of flow outputs
+	uint64_t size{};
+	uint64_t begin{};
+	uint64_t end{UINT64_MAX};
+	std::string filter;
+	uint32_t threads{};
+};
+
+struct Range
+{
+	uint64_t offset;
+	uint64_t size;
+};
+
+void usage()
+{
+	std::cerr << "usage: pcap_split <input> <output prefix> (--packets N | --seconds S | --flows N)\n"
+		     "                  [--begin NS] [--end NS] [--filter EXPRESSION] [--threads N]\n"
+		     "  --packets N   every output holds N packets\n"
+		     "  --seconds S   every output holds a time window of S seconds\n"
+		     "  --flows N     packets are spread over N outputs by IPv4 5-tuple hash, other packets go to the first one\n"
+		     "  --begin/--end only packets with timestamps in [begin, end) nanoseconds are kept\n"
+		     "  --filter      only packets accepted by the filter expression are kept\n"
+		     "PCAP inputs are copied as byte ranges by worker threads, pcapng and compressed inputs are rewritten as PCAP.\n";
+}
+
+uint64_t number(std::string_view text)
+{
+	uint64_t value{};
+	const auto [end, error]{std::from_chars(text.data(), text.data() + text.size(), value)};
+
+	if (error != std::errc{} or end != text.data() + text.size())
+	{
+		throw std::invalid_argument(std::format("pcap_split: '{}' is not a number", text));
+	}
+
+	return value;
+}
+
+std::optional<Arguments> parseArguments(int argc, char** argv)
+{
+	if (argc < 5)
+	{
+		return std::nullopt;
+	}
+
+	Arguments arguments{};
+	arguments.input = argv[1];
+	arguments.prefix = argv[2];
+
+	for (auto i{3}; i + 1 < argc; i += 2)
+	{
+		const std::string_view option{argv[i]};
+		const std::string_view value{argv[i + 1]};
+
+		if (option == "--packets")
+		{
+			arguments.split = Split::packets;
+			arguments.size = number(value);
+		}
+		else if (option == "--seconds")
+		{
+			arguments.split = Split::time;
+			arguments.size = number(value) * 1'000'000'000;
+		}
+		else if (option == "--flows")
+		{
+			arguments.split = Split::flows;
+			arguments.size = number(value);
+		}
+		else if (option == "--begin")
+		{
+			arguments.begin = number(value);
+		}
+		else if (option == "--end")
+		{
+			arguments.end = number(value);
+		}
+		else if (option == "--filter")
+		{
+			arguments.filter = value;
+		}
+		else if (option == "--threads")
+		{
+			arguments.threads = static_cast<uint32_t>(number(value));
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+
+	if ((argc - 3) % 2 != 0 or arguments.size == 0)
+	{
+		return std::nullopt;
+	}
+
+	return arguments;
+}
+
+bool isPcapng(const std::string& fileName)
+{
+	const auto descriptor{::open(fileName.c_str(), O_RDONLY | O_CLOEXEC)};
+
+	if (descriptor == -1)
+	{
+		throw std::runtime_error(std::format("pcap_split: cannot open '{}': {}", fileName, std::strerror(errno)));
+	}
+
+	uint8_t magic[4]{};
+	const auto size{::pread(descriptor, magic, sizeof(magic), 0)};
+	::close(descriptor);
+
+	return size == sizeof(magic) and pcap::PcapngDecoder::isSectionHeader(magic);
+}
+
+std::string outputName(const std::string& prefix, uint64_t index)
+{
+	return std::format("{}_{:05}.pcap", prefix, index);
+}
+
+// copies in the kernel: copy_file_range() shares extents on file systems that support it,
+// sendfile() is the fallback when the files are on different file systems
+void copyRange(int input, int output, Range range)
+{
+	auto offset{static_cast<loff_t>(range.offset)};
+	auto useSendfile{false};
+
+	while (range.size != 0)
+	{
+		const auto copied{useSendfile ? ::sendfile(output, input, &offset, range.size) :
+						::copy_file_range(input, &offset, output, nullptr, range.size, 0)};
+
+		if (copied == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			if (not useSendfile and (errno == EXDEV or errno == ENOSYS or errno == EINVAL or errno == EOPNOTSUPP))
+			{
+				useSendfile = true;
+				continue;
+			}
+
+			throw std::runtime_error(std::format("pcap_split: cannot copy: {}", std::strerror(errno)));
+		}
+
+		if (copied == 0)
+		{
+			throw std::runtime_error("pcap_split: cannot copy: input file is truncated");
+		}
+
+		range.size -= copied;
+	}
+}
+
+void copyOutputs(const Arguments& arguments, const std::vector<std::vector<Range>>& outputs)
+{
+	const auto input{::open(arguments.input.c_str(), O_RDONLY | O_CLOEXEC)};
+
+	if (input == -1)
+	{
+		throw std::runtime_error(std::format("pcap_split: cannot open '{}': {}", arguments.input, std::strerror(errno)));
+	}
+
+	std::atomic<uint64_t> next{};
+	std::mutex mutex;
+	std::exception_ptr exception;
+
+	const auto work{[&]
+			{
+				for (auto index{next++}; index < outputs.size(); index = next++)
+				{
+					if (outputs[index].empty())
+					{
+						continue;
+					}
+
+					const auto name{outputName(arguments.prefix, index)};
+					const auto output{::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+
+					try
+					{
+						if (output == -1)
+						{
+							throw std::runtime_error(std::format("pcap_split: cannot open '{}': {}", name, std::strerror(errno)));
+						}
+
+						// the file header comes first, then the records in file order
+						copyRange(input, output, Range{0, sizeof(pcap::FileReader::FileHeader)});
+
+						for (const auto& range : outputs[index])
+						{
+							copyRange(input, output, range);
+						}
+
+						::close(output);
+					}
+					catch (...)
+					{
+						if (output != -1)
+						{
+							::close(output);
+						}
+
+						std::lock_guard lock{mutex};
+						exception = std::current_exception();
+						return;
+					}
+				}
+			}};
+
+	{
+		const auto threads{arguments.threads != 0 ? arguments.threads : std::max(1u, std::thread::hardware_concurrency())};
+		std::vector<std::jthread> workers;
+
+		for (uint32_t i{}; i < threads; ++i)
+		{
+			workers.emplace_back(work);
+		}
+	}
+
+	::close(input);
+
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+// flow tables take slots from the low hash bits, outputs are picked from the high ones
+uint64_t flowOutput(const pcap::FiveTuple& tuple, uint64_t outputs) noexcept
+{
+	return tuple.valid ? (((std::hash<pcap::FiveTuple>{}(tuple) >> 32) * outputs) >> 32) : 0;
+}
+
+uint64_t run(const Arguments& arguments)
+{
+	pcap::FileReader reader{arguments.input, pcap::FileReader::Options{.mode = pcap::FileReader::Mode::memoryMapped}};
+
+	// records are copied by their file offsets, which only holds for mapped PCAP files: pcapng blocks are rewritten
+	// as PCAP records, offsets of compressed files count decompressed bytes
+	const auto rewrite{reader.mode() != pcap::FileReader::Mode::memoryMapped or isPcapng(arguments.input)};
+
+	if (not arguments.filter.empty())
+	{
+		reader.setFilter(pcap::Filter{arguments.filter});
+	}
+
+	if (arguments.begin != 0 and not reader.seekTime(arguments.begin))
+	{
+		return 0;
+	}
+
+	// scan: only record boundaries are decoded, packets are assigned to outputs
+	std::vector<std::vector<Range>> outputs;
+	std::vector<std::unique_ptr<pcap::FileWriter>> writers;
+	std::vector<pcap::FiveTuple> tuples;
+	pcap::PacketBatch batch;
+	std::optional<uint64_t> firstTimestamp;
+	uint64_t packets{};
+
+	if (arguments.split == Split::flows)
+	{
+		outputs.resize(arguments.size);
+	}
+
+	while (reader.readBatch(batch, scanBatchPackets))
+	{
+		const auto batchOffset{reader.readBytes() - batch.data().size()};
+		const auto timestamps{batch.timestamps()};
+		const auto offsets{batch.offsets()};
+		const auto lengths{batch.lengths()};
+
+		if (arguments.split == Split::flows)
+		{
+			batch.fiveTuples(tuples);
+		}
+
+		for (uint64_t i{}; i < batch.size(); ++i)
+		{
+			if (timestamps[i] < arguments.begin or timestamps[i] >= arguments.end)
+			{
+				continue;
+			}
+
+			if (not firstTimestamp)
+			{
+				firstTimestamp = timestamps[i];
+			}
+
+			uint64_t output{};
+
+			switch (arguments.split)
+			{
+			case Split::packets:
+				output = packets / arguments.size;
+				break;
+			case Split::time:
+				output = timestamps[i] >= *firstTimestamp ? (timestamps[i] - *firstTimestamp) / arguments.size : 0;
+				break;
+			case Split::flows:
+				output = flowOutput(tuples[i], arguments.size);
+				break;
+			}
+
+			++packets;
+
+			if (rewrite)
+			{
+				writers.resize(std::max<uint64_t>(writers.size(), output + 1));
+
+				if (not writers[output])
+				{
+					writers[output] = std::make_unique<pcap::FileWriter>(
+						outputName(arguments.prefix, output),
+						pcap::FileWriter::Options{.linkLayerType = batch.linkLayerTypes()[i]});
+				}
+
+				writers[output]->write(timestamps[i], batch.data(i), batch.originalLengths()[i]);
+				continue;
+			}
+
+			outputs.resize(std::max<uint64_t>(outputs.size(), output + 1));
+
+			const Range record{batchOffset + offsets[i] - sizeof(pcap::FileReader::PacketHeader),
+					   sizeof(pcap::FileReader::PacketHeader) + lengths[i]};
+			auto& ranges{outputs[output]};
+
+			if (not ranges.empty() and ranges.back().offset + ranges.back().size == record.offset)
+			{
+				ranges.back().size += record.size;
+			}
+			else
+			{
+				ranges.push_back(record);
+			}
+		}
+	}
+
+	for (auto& writer : writers)
+	{
+		if (writer)
+		{
+			writer->close();
+		}
+	}
+
+	if (not rewrite)
+	{
+		copyOutputs(arguments, outputs);
+	}
+
+	return packets;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		const auto arguments{parseArguments(argc, argv)};
+
+		if (not arguments)
+		{
+			usage();
+			return 2;
+		}
+
+		const auto packets{run(*arguments)};
+		std::cout << std::format("pcap_split: {} packets written\n", packets);
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}